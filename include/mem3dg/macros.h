@@ -15,7 +15,9 @@
 #pragma once
 
 #include <exception>
+#include <iostream>
 #include <sstream>
+#include <stdexcept>
 
 namespace mem3dg {
 namespace internal {
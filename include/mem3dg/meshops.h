@@ -260,15 +260,21 @@ inline double signedVolumeFromFace(gcs::Face &f,
 }
 
 /**
- * @brief Get mesh volume
+ * @brief Get mesh volume from vertex positions
  *
- * @param f
- * @param vpg
+ * @param mesh
+ * @param positions
+ * @param isFillHole
  * @return double
  */
-DLL_PUBLIC inline double getMeshVolume(gcs::ManifoldSurfaceMesh &mesh,
-                                       gcs::VertexPositionGeometry &vpg,
-                                       bool isFillHole = true) {
+DLL_PUBLIC inline double
+getMeshVolume(gcs::ManifoldSurfaceMesh &mesh,
+              const Eigen::Ref<const EigenVectorX3dr> &positions,
+              bool isFillHole = true) {
+  auto position = [&positions](gcs::Vertex v) {
+    std::size_t i = v.getIndex();
+    return gc::Vector3{positions(i, 0), positions(i, 1), positions(i, 2)};
+  };
   double volume = 0;
 
   // Throw error or fill hole for open mesh
@@ -276,10 +282,12 @@ DLL_PUBLIC inline double getMeshVolume(gcs::ManifoldSurfaceMesh &mesh,
     if (isFillHole) {
       for (gcs::BoundaryLoop bl : mesh.boundaryLoops()) {
         gcs::Vertex theVertex = bl.halfedge().tailVertex();
+        gc::Vector3 p2 = position(theVertex);
         for (gcs::Halfedge e : bl.adjacentHalfedges()) {
           if (e.tailVertex() != theVertex && e.tipVertex() != theVertex) {
-            volume += signedVolumeFromFace(e.tailVertex(), e.tipVertex(),
-                                           theVertex, vpg);
+            gc::Vector3 p0 = position(e.tailVertex()),
+                        p1 = position(e.tipVertex());
+            volume += signedVolumeFromFace(p0, p1, p2);
           }
         }
       }
@@ -290,12 +298,28 @@ DLL_PUBLIC inline double getMeshVolume(gcs::ManifoldSurfaceMesh &mesh,
   }
 
   for (gcs::Face f : mesh.faces()) {
-    volume += signedVolumeFromFace(f, vpg);
+    gcs::Halfedge he = f.halfedge();
+    gc::Vector3 p0 = position(he.tailVertex()), p1 = position(he.tipVertex()),
+                p2 = position(he.next().tipVertex());
+    volume += signedVolumeFromFace(p0, p1, p2);
   }
 
   return volume;
 }
 
+/**
+ * @brief Get mesh volume
+ *
+ * @param f
+ * @param vpg
+ * @return double
+ */
+DLL_PUBLIC inline double getMeshVolume(gcs::ManifoldSurfaceMesh &mesh,
+                                       gcs::VertexPositionGeometry &vpg,
+                                       bool isFillHole = true) {
+  return getMeshVolume(mesh, toMatrix(vpg.inputVertexPositions), isFillHole);
+}
+
 /**
  * @brief Get average data
  *
@@ -0,0 +1,168 @@
+// Membrane Dynamics in 3D using Discrete Differential Geometry (Mem3DG)
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright (c) 2020:
+//     Laboratory for Computational Cellular Mechanobiology
+//     Cuncheng Zhu (cuzhu@eng.ucsd.edu)
+//     Christopher T. Lee (ctlee@ucsd.edu)
+//     Ravi Ramamoorthi (ravir@cs.ucsd.edu)
+//     Padmini Rangamani (prangamani@eng.ucsd.edu)
+//
+
+
+/**
+ * @file  async_trajfile_writer.h
+ * @brief Asynchronous output of mutable trajectory frames
+ *
+ */
+
+#pragma once
+
+#ifdef MEM3DG_WITH_NETCDF
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "mem3dg/macros.h"
+#include "mem3dg/solver/mutable_trajfile.h"
+#include "mem3dg/type_utilities.h"
+
+namespace mem3dg {
+namespace solver {
+
+/**
+ * @brief Copy of a trajectory frame buffered for output
+ */
+struct DLL_PUBLIC TrajFrame {
+  /// time
+  double time = 0;
+  /// face-vertex topology
+  EigenVectorX3ur topology;
+  /// vertex coordinates
+  EigenVectorX3dr coordinates;
+  /// vertex velocity
+  EigenVectorX3dr velocity;
+  /// protein density
+  EigenVectorX1d proteinDensity;
+  /// external force, only written if hasExternalForce
+  EigenVectorX3dr externalForce;
+  /// whether to write the external force
+  bool hasExternalForce = false;
+
+  /**
+   * @brief Write the frame to a trajectory file and sync it to disk
+   *
+   * @param file  Trajectory file
+   * @param idx   Index of the frame
+   */
+  void write(MutableTrajFile &file, const std::size_t idx) const;
+};
+
+/**
+ * @brief Writer of trajectory frames on a background thread
+ *
+ * Frames are copied into a ring of preallocated buffers and written in order
+ * by the background thread, so the file is identical to the one written
+ * synchronously with TrajFrame::write. At most queueDepth frames are pending
+ * at a time; acquireFrame blocks until a buffer is free. The NetCDF library
+ * is not thread safe, the file must not be accessed otherwise until flush
+ * returns.
+ */
+class DLL_PUBLIC AsyncTrajFileWriter {
+public:
+  /**
+   * @brief Start the writer thread
+   *
+   * @param file_       Opened trajectory file to append frames to
+   * @param queueDepth  Number of frame buffers, 2 for double buffering
+   */
+  AsyncTrajFileWriter(MutableTrajFile &file_, std::size_t queueDepth = 2);
+
+  /**
+   * @brief Start the writer thread
+   *
+   * @param file_       Opened trajectory file to write frames to
+   * @param queueDepth  Number of frame buffers, 2 for double buffering
+   * @param firstIndex  Frame index of the first submitted frame
+   */
+  AsyncTrajFileWriter(MutableTrajFile &file_, std::size_t queueDepth,
+                      std::size_t firstIndex);
+
+  /**
+   * @brief Write the pending frames and stop the writer thread
+   */
+  ~AsyncTrajFileWriter();
+
+  AsyncTrajFileWriter(const AsyncTrajFileWriter &) = delete;
+  AsyncTrajFileWriter &operator=(const AsyncTrajFileWriter &) = delete;
+
+  /**
+   * @brief Get a free buffer for the next frame, blocking while all buffers
+   * are pending. The buffer keeps its storage from earlier frames.
+   *
+   * @exception Rethrows the failure of an earlier write
+   */
+  TrajFrame &acquireFrame();
+
+  /**
+   * @brief Queue the buffer from acquireFrame for writing
+   */
+  void submitFrame();
+
+  /**
+   * @brief Block until all submitted frames are written
+   *
+   * @exception Rethrows the failure of an earlier write
+   */
+  void flush();
+
+  /**
+   * @brief Number of frames submitted since construction
+   */
+  std::size_t nSubmitted() const { return nSubmittedFrames; }
+
+private:
+  /// Loop of the writer thread
+  void run();
+
+  /// Rethrow and clear the failure of the writer thread, requires the lock
+  void rethrowError();
+
+  /// Trajectory file
+  MutableTrajFile &file;
+  /// Ring of frame buffers
+  std::vector<TrajFrame> buffers;
+  /// Buffer to be written next
+  std::size_t head = 0;
+  /// Number of submitted frames not yet written
+  std::size_t nPending = 0;
+  /// Number of frames submitted
+  std::size_t nSubmittedFrames = 0;
+  /// Frame index of the next write
+  std::size_t nextIndex;
+  /// Whether a buffer is handed out by acquireFrame
+  bool isAcquired = false;
+  /// Whether the writer thread should exit once the queue is empty
+  bool isStopping = false;
+  /// Failure of the writer thread
+  std::exception_ptr error;
+
+  std::mutex mutex;
+  /// Signaled when a frame is submitted or the writer is stopping
+  std::condition_variable frameSubmitted;
+  /// Signaled when a frame is written
+  std::condition_variable frameWritten;
+  /// Writer thread
+  std::thread worker;
+};
+
+} // namespace solver
+} // namespace mem3dg
+#endif
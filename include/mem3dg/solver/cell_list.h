@@ -0,0 +1,81 @@
+// Membrane Dynamics in 3D using Discrete Differential Geometry (Mem3DG)
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright (c) 2020:
+//     Laboratory for Computational Cellular Mechanobiology
+//     Cuncheng Zhu (cuzhu@eng.ucsd.edu)
+//     Christopher T. Lee (ctlee@ucsd.edu)
+//     Ravi Ramamoorthi (ravir@cs.ucsd.edu)
+//     Padmini Rangamani (prangamani@eng.ucsd.edu)
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <Eigen/Core>
+
+#include "mem3dg/macros.h"
+#include "mem3dg/type_utilities.h"
+
+namespace mem3dg {
+namespace solver {
+
+/**
+ * @brief Uniform grid (cell list) over vertex positions, hashed by cell, for
+ * finding vertex pairs within a cutoff distance in near linear time
+ */
+class DLL_PUBLIC CellList {
+public:
+  /**
+   * @brief Bin positions into cubic cells of the given size
+   */
+  void build(const Eigen::Ref<const EigenVectorX3dr> &positions,
+             double cellSize_);
+
+  /**
+   * @brief Find all pairs (i, j > i) with distance less than cutoff, which
+   * can not exceed the cell size. Neighbors of i are sorted ascendingly in
+   * [offsets[i], offsets[i + 1])
+   */
+  void findPairs(const Eigen::Ref<const EigenVectorX3dr> &positions,
+                 double cutoff, std::vector<std::size_t> &offsets,
+                 std::vector<std::size_t> &neighbors) const;
+
+  /**
+   * @brief Append to candidates all (unsorted) points binned in the cells
+   * adjacent to position
+   */
+  void findCandidates(const Eigen::Ref<const Eigen::RowVector3d> &position,
+                      std::vector<std::size_t> &candidates) const;
+
+  /// size of the cubic cell
+  double cellSize = 0;
+
+private:
+  /// size of the cells of the grid, larger than cellSize if the bounding box
+  /// spans too many cells
+  double gridSize = 0;
+  /// lower corner of the grid
+  Eigen::RowVector3d origin;
+  /// number of cells in each direction
+  std::int64_t nx = 0, ny = 0, nz = 0;
+  /// point indices sorted by cell
+  std::vector<std::size_t> sortedIndices;
+  /// range of sortedIndices of each nonempty cell
+  std::unordered_map<std::int64_t, std::pair<std::size_t, std::size_t>>
+      cellRanges;
+
+  /// cell coordinate of a position along one axis
+  std::int64_t cellCoordinate(double x, double x0, std::int64_t n) const;
+};
+
+} // namespace solver
+} // namespace mem3dg
@@ -0,0 +1,63 @@
+// Membrane Dynamics in 3D using Discrete Differential Geometry (Mem3DG)
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright (c) 2020:
+//     Laboratory for Computational Cellular Mechanobiology
+//     Cuncheng Zhu (cuzhu@eng.ucsd.edu)
+//     Christopher T. Lee (ctlee@ucsd.edu)
+//     Ravi Ramamoorthi (ravir@cs.ucsd.edu)
+//     Padmini Rangamani (prangamani@eng.ucsd.edu)
+//
+
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+
+#include "mem3dg/macros.h"
+#include "mem3dg/solver/topology_cache.h"
+#include "mem3dg/type_utilities.h"
+
+namespace mem3dg {
+namespace solver {
+
+/**
+ * @brief Cotan Laplacian with a fixed sparsity pattern. The pattern and the
+ * map from halfedges to nonzeros are built once per topology; on each step
+ * only the values are rewritten from the halfedge cotan weights.
+ */
+class DLL_PUBLIC CotanLaplacianAssembler {
+public:
+  /// cotan Laplacian, same convention as gcs::VertexPositionGeometry
+  Eigen::SparseMatrix<double> matrix;
+  /// number of pattern builds
+  std::size_t nPatternBuilds = 0;
+
+  /**
+   * @brief Build the sparsity pattern and the halfedge to nonzero map from
+   * the flat connectivity
+   */
+  void buildPattern(const MeshTopologyCache &topo);
+
+  /**
+   * @brief Rewrite the values of the matrix in place
+   * @param halfedgeCotanWeights cotan weights indexed by halfedge
+   */
+  void update(const EigenVectorX1d &halfedgeCotanWeights);
+
+private:
+  /// offsets into the values of the (tail, tail), (tip, tip), (tail, tip)
+  /// and (tip, tail) nonzeros of each halfedge
+  std::vector<std::array<Eigen::Index, 4>> halfedgeNonzeros;
+};
+
+} // namespace solver
+} // namespace mem3dg
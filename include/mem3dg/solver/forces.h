@@ -27,6 +27,7 @@
 
 #include <Eigen/Core>
 
+#include <initializer_list>
 #include <math.h>
 #include <vector>
 
@@ -136,6 +137,54 @@ struct Forces {
   /// Cached chemical potential
   gcs::VertexData<double> chemicalPotential;
 
+  /// whether the force computation fills the diagnostic decompositions
+  /// (bending and deviatoric components) and the scalar normal projections
+  /// of the force terms, otherwise they are zeroed until recomputed with the
+  /// flag on (see System::computeForceDiagnostics)
+  bool isDiagnostic = true;
+  /// whether the diagnostic arrays hold values of a force computation since
+  /// the last clearDiagnostics
+  bool hasDiagnostics = false;
+
+  /**
+   * @brief Set isDiagnostic for the lifetime of the scope and restore the
+   * previous value when leaving it
+   */
+  struct DiagnosticScope {
+    DiagnosticScope(Forces &forces_, bool isDiagnostic)
+        : forces(forces_), previous(forces_.isDiagnostic) {
+      forces.isDiagnostic = isDiagnostic;
+    }
+    ~DiagnosticScope() { forces.isDiagnostic = previous; }
+    DiagnosticScope(const DiagnosticScope &) = delete;
+    DiagnosticScope &operator=(const DiagnosticScope &) = delete;
+
+  private:
+    Forces &forces;
+    bool previous;
+  };
+
+  /**
+   * @brief Zero the diagnostic decompositions and scalar projections, such
+   * that none of them outlives the configuration it was computed for. No-op
+   * if already cleared
+   */
+  void clearDiagnostics() {
+    if (!hasDiagnostics)
+      return;
+    for (auto *vector :
+         {&bendingForceVec_areaGrad, &bendingForceVec_gaussVec,
+          &bendingForceVec_schlafliVec, &deviatoricForceVec_mean,
+          &deviatoricForceVec_gauss})
+      vector->fill({0, 0, 0});
+    for (auto *scalar :
+         {&bendingForce, &deviatoricForce, &capillaryForce, &osmoticForce,
+          &lineCapillaryForce, &adsorptionForce, &aggregationForce,
+          &externalForce, &selfAvoidanceForce})
+      scalar->fill(0);
+    hasDiagnostics = false;
+  }
+
   /// force mask
   gcs::VertexData<gc::Vector3> forceMask;
   /// protein mask
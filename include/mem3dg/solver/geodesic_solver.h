@@ -0,0 +1,80 @@
+// Membrane Dynamics in 3D using Discrete Differential Geometry (Mem3DG)
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright (c) 2020:
+//     Laboratory for Computational Cellular Mechanobiology
+//     Cuncheng Zhu (cuzhu@eng.ucsd.edu)
+//     Christopher T. Lee (ctlee@ucsd.edu)
+//     Ravi Ramamoorthi (ravir@cs.ucsd.edu)
+//     Padmini Rangamani (prangamani@eng.ucsd.edu)
+//
+
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+#include <geometrycentral/surface/heat_method_distance.h>
+#include <geometrycentral/surface/surface_point.h>
+#include <geometrycentral/surface/vertex_position_geometry.h>
+
+#include "mem3dg/macros.h"
+#include "mem3dg/type_utilities.h"
+
+namespace mem3dg {
+namespace solver {
+
+namespace gcs = ::geometrycentral::surface;
+
+/**
+ * @brief Heat method geodesic distance with a reused factorization. The
+ * factorized heat and Poisson operators are kept while the topology and the
+ * vertex positions are unchanged, so by default the distance depends only on
+ * the current geometry and a run restarted from a checkpoint reproduces it.
+ *
+ * A positive tolerance opts into reusing the operators of a reference
+ * geometry while every vertex stays within tolerance * (mean edge length) of
+ * it. The result is then the heat method distance on the reference operators:
+ * for well shaped triangles the cotan weights and vertex areas are perturbed
+ * by O(tolerance) relative to the current ones, and so is the distance to
+ * first order. Since the reference depends on the history of the trajectory,
+ * the distance is no longer a function of the current geometry alone and a
+ * restarted run may diverge from an uninterrupted one.
+ */
+class DLL_PUBLIC GeodesicSolver {
+public:
+  /// maximum vertex displacement since the last factorization, relative to
+  /// the mean edge length at that time, before refactoring. 0 refactors on
+  /// any motion; positive values trade O(tolerance) error for reuse
+  double tolerance = 0;
+  /// number of distance computations reusing the factorization
+  std::size_t nHits = 0;
+  /// number of distance computations that (re)factorized
+  std::size_t nMisses = 0;
+
+  /**
+   * @brief Compute the geodesic distance from a surface point
+   */
+  gcs::VertexData<double> computeDistance(gcs::VertexPositionGeometry &vpg,
+                                          const gcs::SurfacePoint &point);
+
+  /**
+   * @brief Discard the factorization, needed when the topology changes
+   */
+  void invalidate() { heatSolver.reset(); }
+
+private:
+  /// heat method solver holding the factorized operators
+  std::unique_ptr<gcs::HeatMethodDistanceSolver> heatSolver;
+  /// vertex positions at the last factorization
+  EigenVectorX3dr referencePositions;
+  /// mean edge length at the last factorization
+  double referenceEdgeLength = 0;
+};
+
+} // namespace solver
+} // namespace mem3dg
@@ -0,0 +1,92 @@
+// Membrane Dynamics in 3D using Discrete Differential Geometry (Mem3DG)
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright (c) 2020:
+//     Laboratory for Computational Cellular Mechanobiology
+//     Cuncheng Zhu (cuzhu@eng.ucsd.edu)
+//     Christopher T. Lee (ctlee@ucsd.edu)
+//     Ravi Ramamoorthi (ravir@cs.ucsd.edu)
+//     Padmini Rangamani (prangamani@eng.ucsd.edu)
+//
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <geometrycentral/surface/vertex_position_geometry.h>
+
+#include "mem3dg/macros.h"
+#include "mem3dg/solver/parameters.h"
+
+namespace mem3dg {
+namespace solver {
+
+namespace gcs = ::geometrycentral::surface;
+
+/**
+ * @brief Plan the geometry-central quantities required by the active terms
+ * of Parameters, and refresh only those, timing each quantity
+ */
+class DLL_PUBLIC GeometryRefreshPlanner {
+public:
+  struct Quantity {
+    /// name of the quantity
+    std::string name;
+    /// whether the quantity is needed given the parameters
+    std::function<bool(const Parameters &)> isNeeded;
+    /// require the quantity from the geometry
+    std::function<void(gcs::VertexPositionGeometry &)> require;
+    /// unrequire the quantity from the geometry
+    std::function<void(gcs::VertexPositionGeometry &)> unrequire;
+    /// whether the quantity is currently required by the planner
+    bool isPlanned = false;
+    /// number of refreshes
+    std::size_t nRefresh = 0;
+    /// accumulated refresh time (s)
+    double time = 0;
+  };
+
+  /// quantities in the order of dependency
+  std::vector<Quantity> quantities;
+  /// option to time each quantity, which recomputes them one at a time
+  /// instead of in a single refreshQuantities
+  bool isTiming = false;
+
+  GeometryRefreshPlanner();
+
+  /**
+   * @brief Require the quantities needed by the parameters and unrequire the
+   * ones no longer needed
+   */
+  void plan(const Parameters &p, gcs::VertexPositionGeometry &vpg);
+
+  /**
+   * @brief Recompute the planned quantities from the current vertex positions
+   */
+  void refresh(gcs::VertexPositionGeometry &vpg);
+
+  /**
+   * @brief Unrequire all planned quantities
+   */
+  void release(gcs::VertexPositionGeometry &vpg);
+
+  /**
+   * @brief Accumulated refresh time (s) of each quantity
+   */
+  std::map<std::string, double> getTiming() const;
+
+  /**
+   * @brief Print the refresh count and time of each quantity
+   */
+  void summarizeTiming() const;
+};
+
+} // namespace solver
+} // namespace mem3dg
@@ -36,6 +36,22 @@ private:
 
   std::size_t countCG = 0;
 
+protected:
+  /**
+   * @brief Save the position in the conjugate direction cycle, the direction
+   * itself is the velocity of the system
+   */
+  void saveSchemeState(std::map<std::string, double> &counters,
+                       std::map<std::string, EigenVectorX1d> &arrays)
+      const override;
+
+  /**
+   * @brief Restore the state saved by saveSchemeState
+   */
+  void restoreSchemeState(
+      const std::map<std::string, double> &counters,
+      const std::map<std::string, EigenVectorX1d> &arrays) override;
+
 public:
   std::size_t restartPeriod = 5;
   bool isBacktrack = true;
@@ -0,0 +1,126 @@
+// Membrane Dynamics in 3D using Discrete Differential Geometry (Mem3DG)
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright (c) 2021:
+//     Laboratory for Computational Cellular Mechanobiology
+//     Cuncheng Zhu (cuzhu@eng.ucsd.edu)
+//     Christopher T. Lee (ctlee@ucsd.edu)
+//     Ravi Ramamoorthi (ravir@cs.ucsd.edu)
+//     Padmini Rangamani (prangamani@eng.ucsd.edu)
+//
+
+
+#pragma once
+
+#include "mem3dg/solver/integrator/integrator.h"
+#include "mem3dg/solver/system.h"
+
+namespace mem3dg {
+namespace solver {
+namespace integrator {
+/**
+ * @brief Fast Inertial Relaxation Engine (FIRE) minimizer. Steps with
+ * semi-implicit Euler dynamics, mixes the velocity toward the force and
+ * adapts the time step, requiring only force evaluations.
+ * @param maxTimeStepFactor, maximum time step relative to the characteristic
+ * time step
+ * @param nDelay, number of downhill steps before accelerating
+ * @param timeStepIncrease, time step increase factor
+ * @param timeStepDecrease, time step decrease factor on uphill steps
+ * @param initialMixing, initial velocity mixing coefficient
+ * @param mixingDecrease, mixing coefficient decrease factor
+ * @param constraintTolerance, tolerance for termination (contraints)
+ * @param isAugmentedLagrangian, option to use Augmented Lagrangian method
+ * @return Success, if simulation is sucessful
+ */
+class DLL_PUBLIC FIRE : public Integrator {
+public:
+  double maxTimeStepFactor = 10;
+  std::size_t nDelay = 5;
+  double timeStepIncrease = 1.1;
+  double timeStepDecrease = 0.5;
+  double initialMixing = 0.1;
+  double mixingDecrease = 0.99;
+  double constraintTolerance = 0.01;
+  bool isAugmentedLagrangian = false;
+  /// number of FIRE steps taken
+  std::size_t nIterations = 0;
+
+private:
+  /// velocity mixing coefficient, declared after initialMixing which
+  /// initializes it
+  double mixing;
+  /// number of consecutive downhill steps
+  std::size_t nDownhill = 0;
+
+protected:
+  /**
+   * @brief Save the velocity mixing adaptation
+   */
+  void saveSchemeState(std::map<std::string, double> &counters,
+                       std::map<std::string, EigenVectorX1d> &arrays)
+      const override;
+
+  /**
+   * @brief Restore the state saved by saveSchemeState
+   */
+  void restoreSchemeState(
+      const std::map<std::string, double> &counters,
+      const std::map<std::string, EigenVectorX1d> &arrays) override;
+
+public:
+
+  FIRE(System &system_, double characteristicTimeStep_, double totalTime_,
+       double savePeriod_, double tolerance_, std::string outputDirectory_)
+      : Integrator(system_, characteristicTimeStep_, totalTime_, savePeriod_,
+                   tolerance_, outputDirectory_),
+        mixing(initialMixing) {
+
+    // print to console
+    std::cout << "Running FIRE propagator ..." << std::endl;
+
+    // check the validity of parameter
+    checkParameters();
+  }
+
+  /**
+   * @brief FIRE driver function
+   */
+  bool integrate() override;
+
+  /**
+   * @brief FIRE stepper
+   */
+  void march() override;
+
+  /**
+   * @brief FIRE status computation and thresholding
+   */
+  void status() override;
+
+  /**
+   * @brief Check parameters for time integration
+   */
+  void checkParameters() override;
+
+  /**
+   * @brief Stop the system and restart the adaptation
+   */
+  void restart();
+
+  /**
+   * @brief step for n iterations
+   */
+  void step(std::size_t n) {
+    for (std::size_t i = 0; i < n; i++) {
+      status();
+      march();
+    }
+  }
+};
+} // namespace integrator
+} // namespace solver
+} // namespace mem3dg
@@ -29,16 +29,53 @@
 #include "mem3dg/solver/system.h"
 
 #include "mem3dg/meshops.h"
+#include "mem3dg/solver/async_trajfile_writer.h"
 #include "mem3dg/solver/mutable_trajfile.h"
 #include "mem3dg/solver/trajfile.h"
 
 #include <csignal>
+#include <memory>
 #include <stdexcept>
 
 namespace mem3dg {
 namespace solver {
 namespace integrator {
 
+/**
+ * @brief Reusable snapshot of the integrated state of a System. The storage
+ * is reallocated only when the number of vertices changes.
+ */
+struct DLL_PUBLIC SystemState {
+  /// vertex positions
+  EigenVectorX3dr positions;
+  /// protein density
+  EigenVectorX1d proteinDensity;
+  /// vertex velocity
+  EigenVectorX3dr velocity;
+  /// time
+  double time = 0;
+
+  /**
+   * @brief Copy the state of the system into the snapshot
+   */
+  void save(System &system) {
+    positions = toMatrix(system.vpg->inputVertexPositions);
+    proteinDensity = system.proteinDensity.raw();
+    velocity = toMatrix(system.velocity);
+    time = system.time;
+  }
+
+  /**
+   * @brief Copy the snapshot back into the system
+   */
+  void restore(System &system) const {
+    toMatrix(system.vpg->inputVertexPositions) = positions;
+    system.proteinDensity.raw() = proteinDensity;
+    toMatrix(system.velocity) = velocity;
+    system.time = time;
+  }
+};
+
 // ==========================================================
 // =============        Integrator             ==============
 // ==========================================================
@@ -62,6 +99,10 @@ protected:
   bool EXIT = false;
   /// Frame index of the trajectory output
   std::size_t frame = 0;
+  /// Index of the next frame written to the trajectory file
+  std::size_t trajFileFrame = 0;
+  /// Whether the integrator continues from a checkpoint
+  bool isRestarted = false;
   /// Normalized area difference to reference mesh
   double areaDifference;
   /// Normalized volume/osmotic pressure difference
@@ -70,12 +111,38 @@ protected:
   double dt_size2_ratio;
   /// initial maximum force
   double initialMaximumForce;
+  /// state of the system at the start of a line search
+  SystemState lineSearchState;
+  /// trial configuration of a line search, buffer reused across trials
+  SystemState lineSearchTrialState;
   /// TrajFile
 #ifdef MEM3DG_WITH_NETCDF
   TrajFile trajFile;
   MutableTrajFile mutableTrajFile;
+  /// background writer of mutableTrajFile, destroyed before the file
+  std::unique_ptr<AsyncTrajFileWriter> trajFileWriter;
 #endif
 
+  /**
+   * @brief Add the state specific to the integration scheme to a checkpoint
+   *
+   * @param counters  Scalar state by name
+   * @param arrays    Vector state by name
+   */
+  virtual void
+  saveSchemeState(std::map<std::string, double> &counters,
+                  std::map<std::string, EigenVectorX1d> &arrays) const {}
+
+  /**
+   * @brief Restore the state added by saveSchemeState
+   *
+   * @param counters  Scalar state by name
+   * @param arrays    Vector state by name
+   */
+  virtual void
+  restoreSchemeState(const std::map<std::string, double> &counters,
+                     const std::map<std::string, EigenVectorX1d> &arrays) {}
+
 public:
   /// System object to be integrated
   System &system;
@@ -102,6 +169,27 @@ public:
   size_t verbosity = 3;
   /// just save geometry .ply file
   bool isJustGeometryPly = false;
+  /// option to write the profile to profile.json in the output directory,
+  /// recorded if system.profiler.isEnabled
+  bool isWriteProfile = false;
+  /// option to write a restart checkpoint to checkpoint.bin in the output
+  /// directory on every save
+  bool isWriteCheckpoint = false;
+  /// option to write the trajectory frames on a background thread
+  bool isAsyncWrite = false;
+  /// maximum number of trajectory frames pending for asynchronous writing
+  std::size_t asyncWriteQueueDepth = 2;
+#ifdef MEM3DG_WITH_NETCDF
+  /// compression, chunking and precision of the trajectory variables
+  TrajFileSettings trajFileSettings;
+#endif
+  /// option to choose line search trial steps by quadratic/cubic
+  /// interpolation of the energy instead of the fixed discount factor
+  bool isInterpolatingLineSearch = false;
+  /// number of line searches
+  std::size_t nLineSearch = 0;
+  /// number of energy evaluations over all line searches
+  std::size_t nLineSearchEnergyEvaluations = 0;
 
   // ==========================================================
   // =============        Constructor            ==============
@@ -178,6 +266,29 @@ public:
 
 #endif
 
+  /**
+   * @brief Print the profile of the simulation and write it to the output
+   * directory if isWriteProfile, nothing if the profiler is disabled
+   */
+  void reportProfile();
+
+  /**
+   * @brief Save the system and the integrator state to a checkpoint
+   */
+  void saveCheckpoint(const std::string &fileName);
+
+  /**
+   * @brief Restore the integrator state read by System::loadCheckpoint. The
+   * integration continues the trajectory in the output directory from the
+   * frame of the checkpoint.
+   *
+   * @param counters  Integrator counters of the checkpoint
+   * @param arrays    Integrator arrays of the checkpoint
+   */
+  void restoreCheckpoint(const std::map<std::string, double> &counters,
+                         const std::map<std::string, EigenVectorX1d> &arrays =
+                             std::map<std::string, EigenVectorX1d>());
+
   /**
    * @brief Mark the file name
    *
@@ -274,6 +385,76 @@ public:
       Eigen::Matrix<double, Eigen::Dynamic, 1> &&chemicalDirection,
       double rho = 0.7, double c1 = 0.001);
 
+  /**
+   * @brief Prepare the energy evaluations of a line search from
+   * lineSearchState with trial steps up to characteristicTimeStep
+   * @param positionDirection, direction of shape
+   * @param isShape, whether the shape is stepped
+   * @param previousE, energy of the system at lineSearchState
+   * @return energy at zero step, evaluated consistently with the trials
+   */
+  double beginLineSearch(
+      const Eigen::Matrix<double, Eigen::Dynamic, 3> &positionDirection,
+      bool isShape, const Energy &previousE);
+
+  /**
+   * @brief Energy of the line search trial at step alpha from lineSearchState,
+   * less the integrated external power if the shape varies. Without external
+   * force the system is left untouched, otherwise it is updated to the trial
+   * configuration
+   * @param alpha, trial step
+   * @param positionDirection, direction of shape
+   * @param chemicalDirection, direction of protein density
+   * @param isShape, whether to step the shape
+   * @param isProtein, whether to step the protein density
+   * @return trial energy
+   */
+  double evaluateLineSearchTrial(
+      double alpha,
+      const Eigen::Matrix<double, Eigen::Dynamic, 3> &positionDirection,
+      const Eigen::Matrix<double, Eigen::Dynamic, 1> &chemicalDirection,
+      bool isShape, bool isProtein);
+
+  /**
+   * @brief Update the system to the line search trial at step alpha from
+   * lineSearchState and compute its potential energy
+   * @param alpha, trial step
+   * @param positionDirection, direction of shape
+   * @param chemicalDirection, direction of protein density
+   * @param isShape, whether to step the shape
+   * @param isProtein, whether to step the protein density
+   */
+  void applyLineSearchTrial(
+      double alpha,
+      const Eigen::Matrix<double, Eigen::Dynamic, 3> &positionDirection,
+      const Eigen::Matrix<double, Eigen::Dynamic, 1> &chemicalDirection,
+      bool isShape, bool isProtein);
+
+  /**
+   * @brief Next trial step of the interpolating line search, from the
+   * minimizer of the quadratic (first reduction) or cubic (later reductions)
+   * model of the energy, safeguarded to [0.1, 0.5] of the current step
+   * @param initialEnergy, energy at zero step
+   * @param initialSlope, directional derivative of energy at zero step
+   * @param alpha, current trial step
+   * @param energy, energy at the current trial step
+   * @param previousAlpha, previous trial step, 0 if none
+   * @param previousEnergy, energy at the previous trial step
+   * @return next trial step
+   */
+  double interpolateStepSize(double initialEnergy, double initialSlope,
+                             double alpha, double energy, double previousAlpha,
+                             double previousEnergy) const;
+
+  /**
+   * @brief Average number of energy evaluations per line search
+   */
+  double getAverageEnergyEvaluations() const {
+    return (nLineSearch == 0) ? 0
+                              : double(nLineSearchEnergyEvaluations) /
+                                    double(nLineSearch);
+  }
+
   /**
    * @brief Check finiteness of simulation states and backtrack for error in
    * specific component
@@ -287,9 +468,9 @@ public:
    * @return
    */
   void lineSearchErrorBacktrace(const double alpha,
-                                const EigenVectorX3dr initial_pos,
-                                const EigenVectorX1d init_proteinDensity,
-                                const Energy previousE, bool runAll = false);
+                                const EigenVectorX3dr &initial_pos,
+                                const EigenVectorX1d &init_proteinDensity,
+                                const Energy &previousE, bool runAll = false);
 
   /**
    * @brief get adaptive characteristic time step
@@ -0,0 +1,131 @@
+// Membrane Dynamics in 3D using Discrete Differential Geometry (Mem3DG)
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright (c) 2021:
+//     Laboratory for Computational Cellular Mechanobiology
+//     Cuncheng Zhu (cuzhu@eng.ucsd.edu)
+//     Christopher T. Lee (ctlee@ucsd.edu)
+//     Ravi Ramamoorthi (ravir@cs.ucsd.edu)
+//     Padmini Rangamani (prangamani@eng.ucsd.edu)
+//
+
+
+#pragma once
+
+#include <deque>
+
+#include "mem3dg/solver/integrator/integrator.h"
+#include "mem3dg/solver/system.h"
+
+namespace mem3dg {
+namespace solver {
+namespace integrator {
+/**
+ * @brief Limited-memory BFGS optimizer. The inverse Hessian is applied with
+ * the two-loop recursion over the last historyLength steps, jointly on the
+ * vertex positions and the protein density.
+ * @param historyLength, number of stored correction pairs
+ * @param isBacktrack, option to use backtracking line search algorithm
+ * @param rho, backtracking coefficient
+ * @param c1, Wolfe condition parameter
+ * @param constraintTolerance, tolerance for termination (contraints)
+ * @param isAugmentedLagrangian, option to use Augmented Lagrangian method
+ * @return Success, if simulation is sucessful
+ */
+class DLL_PUBLIC LBFGS : public Integrator {
+private:
+  /// step of the previous iterations
+  std::deque<EigenVectorX1d> sHistory;
+  /// change of the gradient of the previous iterations
+  std::deque<EigenVectorX1d> yHistory;
+  /// 1 / (y^T s) of the previous iterations
+  std::deque<double> rhoHistory;
+  /// generalized force of the last iteration
+  EigenVectorX1d pastForce;
+  /// step of the last iteration
+  EigenVectorX1d pastStep;
+  /// whether pastForce and pastStep are valid
+  bool isPastStepValid = false;
+
+  /**
+   * @brief Generalized force (negative gradient) on positions (flattened,
+   * row-major) followed by protein density
+   */
+  EigenVectorX1d getForce();
+
+protected:
+  /**
+   * @brief Save the correction pairs of the history
+   */
+  void saveSchemeState(std::map<std::string, double> &counters,
+                       std::map<std::string, EigenVectorX1d> &arrays)
+      const override;
+
+  /**
+   * @brief Restore the state saved by saveSchemeState
+   */
+  void restoreSchemeState(
+      const std::map<std::string, double> &counters,
+      const std::map<std::string, EigenVectorX1d> &arrays) override;
+
+public:
+  std::size_t historyLength = 10;
+  bool isBacktrack = true;
+  double rho = 0.7;
+  double c1 = 0.001;
+  double constraintTolerance = 0.01;
+  bool isAugmentedLagrangian = false;
+
+  LBFGS(System &system_, double characteristicTimeStep_, double totalTime_,
+        double savePeriod_, double tolerance_, std::string outputDirectory_)
+      : Integrator(system_, characteristicTimeStep_, totalTime_, savePeriod_,
+                   tolerance_, outputDirectory_) {
+
+    // print to console
+    std::cout << "Running L-BFGS propagator ..." << std::endl;
+
+    // check the validity of parameter
+    checkParameters();
+  }
+
+  /**
+   * @brief L-BFGS driver function
+   */
+  bool integrate() override;
+
+  /**
+   * @brief L-BFGS stepper
+   */
+  void march() override;
+
+  /**
+   * @brief L-BFGS status computation and thresholding
+   */
+  void status() override;
+
+  /**
+   * @brief Check parameters for time integration
+   */
+  void checkParameters() override;
+
+  /**
+   * @brief Discard the correction history, needed when the mesh changes
+   */
+  void resetHistory();
+
+  /**
+   * @brief step for n iterations
+   */
+  void step(std::size_t n) {
+    for (std::size_t i = 0; i < n; i++) {
+      status();
+      march();
+    }
+  }
+};
+} // namespace integrator
+} // namespace solver
+} // namespace mem3dg
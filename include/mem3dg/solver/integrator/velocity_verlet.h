@@ -31,6 +31,21 @@ private:
   // total energy of the system
   double initialTotalEnergy;
 
+protected:
+  /**
+   * @brief Save the force of the last step and the initial energy
+   */
+  void saveSchemeState(std::map<std::string, double> &counters,
+                       std::map<std::string, EigenVectorX1d> &arrays)
+      const override;
+
+  /**
+   * @brief Restore the state saved by saveSchemeState
+   */
+  void restoreSchemeState(
+      const std::map<std::string, double> &counters,
+      const std::map<std::string, EigenVectorX1d> &arrays) override;
+
 public:
   bool isCapEnergy = true;
   VelocityVerlet(System &system_, double characteristicTimeStep_,
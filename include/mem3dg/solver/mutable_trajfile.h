@@ -22,8 +22,12 @@
 
 #ifdef MEM3DG_WITH_NETCDF
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <exception>
 #include <iostream>
+#include <limits>
 #include <netcdf>
 #include <vector>
 
@@ -47,6 +51,45 @@ namespace gcs = ::geometrycentral::surface;
 
 namespace nc = ::netCDF;
 
+/**
+ * @brief Storage settings of a trajectory variable
+ */
+struct DLL_PUBLIC TrajVariableSettings {
+  /// Storage precision of floating point arrays
+  enum Precision { Double, Float, Fixed };
+
+  /// deflate level from 1 to 9, 0 disables compression
+  int compressionLevel = 5;
+  /// whether to shuffle the bytes before compression
+  bool isShuffle = true;
+  /// number of frames per chunk, 0 for the library default
+  std::size_t chunkSize = 0;
+  /// storage precision, only used by coordinates, velocities, protein density
+  /// and external force
+  Precision precision = Double;
+  /// quantum of the Fixed precision, values are stored as 32 bit integer
+  /// multiples of it
+  double quantum = 1e-6;
+};
+
+/**
+ * @brief Storage settings of the variables of a mutable trajectory
+ */
+struct DLL_PUBLIC TrajFileSettings {
+  /// time
+  TrajVariableSettings time;
+  /// face-vertex topology
+  TrajVariableSettings topology;
+  /// vertex coordinates
+  TrajVariableSettings coordinates;
+  /// vertex velocities
+  TrajVariableSettings velocity;
+  /// protein density
+  TrajVariableSettings proteinDensity;
+  /// external force
+  TrajVariableSettings externalForce;
+};
+
 /**
  * @class MutableTrajFile
  * @brief Trajectory interface to help with manipulating trajectories
@@ -138,6 +181,10 @@ public:
   /// Default constructor
   MutableTrajFile() : writeable(false), fd(nullptr){};
 
+  /// Storage settings applied when creating a file, updated with the
+  /// precision recorded in the file when opening one
+  TrajFileSettings settings;
+
   /// Default copy constructor
   MutableTrajFile(MutableTrajFile &&rhs) = default;
 
@@ -177,10 +224,28 @@ public:
 
     time_var = traj_group.getVar(TIME_VAR);
     topo_var = traj_group.getVar(TOPO_VAR);
+    // files of the legacy convention store the topology of every frame
+    topoFrame_var = traj_group.getVar(TOPO_FRAME_VAR);
+    if (topoFrame_var.isNull() !=
+        (conventionsVersion == CONVENTIONS_VERSION_LEGACY_VALUE))
+      mem3dg_runtime_error("Trajectory layout mismatch. The topology storage "
+                           "does not follow the convention version.");
+    if (!topoFrame_var.isNull()) {
+      topoRevision_dim = traj_group.getDim(TOPO_REVISION_NAME);
+      if (topoRevision_dim.getSize() > 0) {
+        lastRevision = topoRevision_dim.getSize() - 1;
+        lastTopology = getTopologyVar(lastRevision);
+      }
+    }
     coord_var = traj_group.getVar(COORD_VAR);
     phi_var = traj_group.getVar(PHI_VAR);
     vel_var = traj_group.getVar(VEL_VAR);
     extF_var = traj_group.getVar(EXTF_VAR);
+
+    getPrecision(coord_var, settings.coordinates);
+    getPrecision(vel_var, settings.velocity);
+    getPrecision(phi_var, settings.proteinDensity);
+    getPrecision(extF_var, settings.externalForce);
   }
 
   /**
@@ -246,10 +311,16 @@ public:
     parameter_group = nc::NcGroup{};
 
     frame_dim = nc::NcDim{};
+    topoRevision_dim = nc::NcDim{};
     uint_array_t = nc::NcVlenType{};
     double_array_t = nc::NcVlenType{};
+    float_array_t = nc::NcVlenType{};
+    int_array_t = nc::NcVlenType{};
     time_var = nc::NcVar{};
     topo_var = nc::NcVar{};
+    topoFrame_var = nc::NcVar{};
+    lastTopology.resize(0, POLYGON_ORDER);
+    lastRevision = 0;
     coord_var = nc::NcVar{};
     phi_var = nc::NcVar{};
     vel_var = nc::NcVar{};
@@ -288,13 +359,24 @@ public:
 
 #pragma region read_write
   /**
-   * @brief Write the topology for a frame
+   * @brief Write the topology for a frame, only stored as a new revision if
+   * it differs from the last written one
    *
    * @param idx   Index of the frame
    * @param data  Topology matrix
    */
   void writeTopology(const std::size_t idx, const EigenVectorX3ur &data) {
-    writeVar<std::uint32_t, 3>(topo_var, idx, data);
+    if (topoFrame_var.isNull()) {
+      writeVar<std::uint32_t, 3>(topo_var, idx, data);
+      return;
+    }
+    if (topoRevision_dim.getSize() == 0 ||
+        lastTopology.rows() != data.rows() || lastTopology != data) {
+      lastRevision = topoRevision_dim.getSize();
+      writeVar<std::uint32_t, 3>(topo_var, lastRevision, data);
+      lastTopology = data;
+    }
+    writeVar(topoFrame_var, idx, static_cast<std::uint32_t>(lastRevision));
   }
 
   /**
@@ -304,9 +386,8 @@ public:
    * @param data  Surface mesh
    */
   void writeTopology(const std::size_t idx, gc::SurfaceMesh &mesh) {
-    writeVar<std::uint32_t, 3>(
-        topo_var, idx,
-        EigenVectorX3ur{mesh.getFaceVertexMatrix<std::uint32_t>()});
+    writeTopology(idx,
+                  EigenVectorX3ur{mesh.getFaceVertexMatrix<std::uint32_t>()});
   }
 
   /**
@@ -316,7 +397,37 @@ public:
    * @return EigenVectorX3ur
    */
   EigenVectorX3ur getTopology(const std::size_t idx) const {
-    return getVar<std::uint32_t, POLYGON_ORDER>(topo_var, idx);
+    if (topoFrame_var.isNull())
+      return getVar<std::uint32_t, POLYGON_ORDER>(topo_var, idx);
+    std::size_t revision = getTopologyRevision(idx);
+    if (revision >= topoRevision_dim.getSize())
+      return EigenVectorX3ur(0, POLYGON_ORDER);
+    return getTopologyVar(revision);
+  }
+
+  /**
+   * @brief Get the topology revision of a frame, frames of the same revision
+   * share the topology
+   *
+   * @param idx           Index of the frame
+   * @return std::size_t  Revision id, the frame index for files storing the
+   * topology of every frame
+   */
+  std::size_t getTopologyRevision(const std::size_t idx) const {
+    if (topoFrame_var.isNull())
+      return idx;
+    return getVar<std::uint32_t>(topoFrame_var, idx);
+  }
+
+  /**
+   * @brief Get the number of distinct topologies stored
+   *
+   * @return std::size_t Number of topology revisions
+   */
+  std::size_t nTopologyRevisions() const {
+    if (topoFrame_var.isNull())
+      return nFrames();
+    return topoRevision_dim.getSize();
   }
 
   /**
@@ -326,7 +437,7 @@ public:
    * @param data  Coordinate matrix
    */
   void writeCoords(const std::size_t idx, const EigenVectorX3dr &data) {
-    writeVar<double, 3>(coord_var, idx, data);
+    writeArray(coord_var, settings.coordinates, idx, data.data(), data.size());
   }
 
   /**
@@ -337,7 +448,9 @@ public:
    */
   void writeCoords(const std::size_t idx,
                    const gc::VertexPositionGeometry &data) {
-    writeVar<gc::Vertex>(coord_var, idx, data.inputVertexPositions);
+    auto coords = EigenMap<double, 3>(data.inputVertexPositions);
+    writeArray(coord_var, settings.coordinates, idx, coords.data(),
+               coords.size());
   }
 
   /**
@@ -347,7 +460,8 @@ public:
    * @return EigenVectorX3dr  Coordinates data
    */
   EigenVectorX3dr getCoords(const std::size_t idx) {
-    return getVar<double, SPATIAL_DIMS>(coord_var, idx);
+    return getArray<EigenVectorX3dr>(coord_var, settings.coordinates, idx,
+                                     SPATIAL_DIMS);
   }
 
   /**
@@ -358,7 +472,18 @@ public:
    */
   void writeProteinDensity(const std::size_t idx,
                            const gc::MeshData<gc::Vertex, double> &data) {
-    writeVar(phi_var, idx, data);
+    writeProteinDensity(idx, data.raw());
+  }
+
+  /**
+   * @brief Write the protein density for a frame
+   *
+   * @param idx   Index of the frame
+   * @param data  Protein density vector
+   */
+  void writeProteinDensity(const std::size_t idx, const EigenVectorX1d &data) {
+    writeArray(phi_var, settings.proteinDensity, idx, data.data(),
+               data.size());
   }
 
   /**
@@ -368,7 +493,7 @@ public:
    * @return EigenVectorX3dr  Coordinates data
    */
   EigenVectorX1d getProteinDensity(const std::size_t idx) {
-    return getVar1d<double>(phi_var, idx);
+    return getArray<EigenVectorX1d>(phi_var, settings.proteinDensity, idx, 1);
   }
 
   /**
@@ -378,7 +503,7 @@ public:
    * @param data  Velocity matrix
    */
   void writeVelocity(const std::size_t idx, const EigenVectorX3dr &data) {
-    writeVar<double, 3>(vel_var, idx, data);
+    writeArray(vel_var, settings.velocity, idx, data.data(), data.size());
   }
 
   /**
@@ -389,7 +514,9 @@ public:
    */
   void writeVelocity(const std::size_t idx,
                      const gcs::VertexData<gc::Vector3> &data) {
-    writeVar<gc::Vertex>(vel_var, idx, data);
+    auto velocity = EigenMap<double, 3>(data);
+    writeArray(vel_var, settings.velocity, idx, velocity.data(),
+               velocity.size());
   }
 
   /**
@@ -399,7 +526,8 @@ public:
    * @return EigenVectorX3dr  Velocity data
    */
   EigenVectorX3dr getVelocity(const std::size_t idx) const {
-    return getVar<double, SPATIAL_DIMS>(vel_var, idx);
+    return getArray<EigenVectorX3dr>(vel_var, settings.velocity, idx,
+                                     SPATIAL_DIMS);
   }
 
   /**
@@ -409,7 +537,8 @@ public:
    * @param data  Velocity matrix
    */
   void writeExternalForce(const std::size_t idx, const EigenVectorX3dr &data) {
-    writeVar<double, 3>(extF_var, idx, data);
+    writeArray(extF_var, settings.externalForce, idx, data.data(),
+               data.size());
   }
 
   /**
@@ -420,7 +549,9 @@ public:
    */
   void writeExternalForce(const std::size_t idx,
                           const gcs::VertexData<gc::Vector3> &data) {
-    writeVar<gc::Vertex>(extF_var, idx, data);
+    auto force = EigenMap<double, 3>(data);
+    writeArray(extF_var, settings.externalForce, idx, force.data(),
+               force.size());
   }
 
   /**
@@ -430,7 +561,8 @@ public:
    * @return EigenVectorX3dr  Velocity data
    */
   EigenVectorX3dr getExternalForce(const std::size_t idx) const {
-    return getVar<double, SPATIAL_DIMS>(extF_var, idx);
+    return getArray<EigenVectorX3dr>(extF_var, settings.externalForce, idx,
+                                     SPATIAL_DIMS);
   }
 
   /**
@@ -568,7 +700,23 @@ private:
   EigenVectorXkr_T<T, k> getVar(const nc::NcVar &var,
                                 const std::size_t idx) const {
     assert(idx < nFrames());
+    return getVlenVar<T, k>(var, idx);
+  }
 
+  /**
+   * @brief Read a stored topology revision, bounded by the number of
+   * revisions rather than the number of frames
+   *
+   * @param revision  Index of the topology revision
+   */
+  EigenVectorX3ur getTopologyVar(const std::size_t revision) const {
+    assert(revision < nTopologyRevisions());
+    return getVlenVar<std::uint32_t, POLYGON_ORDER>(topo_var, revision);
+  }
+
+  template <typename T, std::size_t k>
+  EigenVectorXkr_T<T, k> getVlenVar(const nc::NcVar &var,
+                                    const std::size_t idx) const {
     nc_vlen_t vlenData;
     var.getVar({idx}, &vlenData);
 
@@ -607,6 +755,179 @@ private:
     return data;
   }
 
+  /**
+   * @brief Write a floating point array in the storage precision of the
+   * variable
+   *
+   * @param var         Variable to write to
+   * @param varSettings Storage settings of the variable
+   * @param idx         Index
+   * @param data        Pointer to the data
+   * @param size        Number of values
+   */
+  void writeArray(nc::NcVar &var, const TrajVariableSettings &varSettings,
+                  const std::size_t idx, const double *data,
+                  const std::size_t size) {
+    if (!writeable)
+      mem3dg_runtime_error("Cannot write to read only file.");
+
+    nc_vlen_t vlenData;
+    vlenData.len = size;
+    switch (varSettings.precision) {
+    case TrajVariableSettings::Double: {
+      vlenData.p = const_cast<double *>(data);
+      var.putVar({idx}, &vlenData);
+      break;
+    }
+    case TrajVariableSettings::Float: {
+      std::vector<float> buffer(data, data + size);
+      vlenData.p = buffer.data();
+      var.putVar({idx}, &vlenData);
+      break;
+    }
+    case TrajVariableSettings::Fixed: {
+      std::vector<std::int32_t> buffer(size);
+      for (std::size_t i = 0; i < size; ++i) {
+        if (!std::isfinite(data[i]))
+          mem3dg_runtime_error("Non-finite value cannot be stored in the "
+                               "fixed precision!");
+        double value = std::round(data[i] / varSettings.quantum);
+        if (std::abs(value) > std::numeric_limits<std::int32_t>::max())
+          mem3dg_runtime_error("Value exceeds the range of the fixed "
+                               "precision, increase the quantum!");
+        buffer[i] = static_cast<std::int32_t>(value);
+      }
+      vlenData.p = buffer.data();
+      var.putVar({idx}, &vlenData);
+      break;
+    }
+    }
+  }
+
+  /**
+   * @brief Read a floating point array stored in any precision
+   *
+   * @tparam EigenT   Row major matrix or column vector of double
+   * @param var         Variable to read from
+   * @param varSettings Storage settings of the variable
+   * @param idx         Index
+   * @param nCols       Number of columns
+   */
+  template <typename EigenT>
+  EigenT getArray(const nc::NcVar &var,
+                  const TrajVariableSettings &varSettings,
+                  const std::size_t idx, const std::size_t nCols) const {
+    assert(idx < nFrames());
+
+    nc_vlen_t vlenData;
+    var.getVar({idx}, &vlenData);
+
+    EigenT data(vlenData.len / nCols, nCols);
+    switch (varSettings.precision) {
+    case TrajVariableSettings::Double: {
+      const double *p = static_cast<const double *>(vlenData.p);
+      std::copy(p, p + vlenData.len, data.data());
+      break;
+    }
+    case TrajVariableSettings::Float: {
+      const float *p = static_cast<const float *>(vlenData.p);
+      std::copy(p, p + vlenData.len, data.data());
+      break;
+    }
+    case TrajVariableSettings::Fixed: {
+      const std::int32_t *p = static_cast<const std::int32_t *>(vlenData.p);
+      for (std::size_t i = 0; i < vlenData.len; ++i)
+        data.data()[i] = p[i] * varSettings.quantum;
+      break;
+    }
+    }
+    nc_free_vlen(&vlenData);
+    return data;
+  }
+
+  /**
+   * @brief Define a variable with its storage settings
+   *
+   * @param name        Name of the variable
+   * @param type        Type of the variable, replaced by the array type of
+   * the storage precision for floating point arrays
+   * @param varSettings Storage settings of the variable
+   */
+  nc::NcVar addVar(const std::string &name, const nc::NcType &type,
+                   const TrajVariableSettings &varSettings) {
+    return addVar(name, type, varSettings, frame_dim);
+  }
+
+  /**
+   * @brief Define a variable with its storage settings along a dimension
+   *
+   * @param name        Name of the variable
+   * @param type        Type of the variable
+   * @param varSettings Storage settings of the variable
+   * @param dim         Unlimited dimension of the variable
+   */
+  nc::NcVar addVar(const std::string &name, const nc::NcType &type,
+                   const TrajVariableSettings &varSettings,
+                   const nc::NcDim &dim) {
+    nc::NcVar var;
+    if (type == double_array_t) {
+      switch (varSettings.precision) {
+      case TrajVariableSettings::Double:
+        var = traj_group.addVar(name, double_array_t, {dim});
+        var.putAtt(PRECISION, std::string("double"));
+        break;
+      case TrajVariableSettings::Float:
+        if (float_array_t.isNull())
+          float_array_t = traj_group.addVlenType(FLOAT_ARR, nc::ncFloat);
+        var = traj_group.addVar(name, float_array_t, {dim});
+        var.putAtt(PRECISION, std::string("float"));
+        break;
+      case TrajVariableSettings::Fixed:
+        if (int_array_t.isNull())
+          int_array_t = traj_group.addVlenType(INT_ARR, nc::ncInt);
+        var = traj_group.addVar(name, int_array_t, {dim});
+        var.putAtt(PRECISION, std::string("fixed"));
+        var.putAtt(SCALE_FACTOR, nc::ncDouble, varSettings.quantum);
+        break;
+      }
+    } else {
+      var = traj_group.addVar(name, type, {dim});
+    }
+    if (varSettings.chunkSize > 0) {
+      std::vector<std::size_t> chunkSizes{varSettings.chunkSize};
+      var.setChunking(nc::NcVar::nc_CHUNKED, chunkSizes);
+    }
+    if (varSettings.compressionLevel > 0)
+      var.setCompression(varSettings.isShuffle, true,
+                         varSettings.compressionLevel);
+    return var;
+  }
+
+  /**
+   * @brief Get the storage precision recorded in a variable, files without
+   * the record are in double precision
+   *
+   * @param var         Variable
+   * @param varSettings Storage settings to update
+   */
+  void getPrecision(const nc::NcVar &var, TrajVariableSettings &varSettings) {
+    varSettings.precision = TrajVariableSettings::Double;
+    auto atts = var.getAtts();
+    if (atts.find(PRECISION) == atts.end())
+      return;
+    std::string precision;
+    atts.at(PRECISION).getValues(precision);
+    if (precision == "float") {
+      varSettings.precision = TrajVariableSettings::Float;
+    } else if (precision == "fixed") {
+      varSettings.precision = TrajVariableSettings::Fixed;
+      atts.at(SCALE_FACTOR).getValues(&varSettings.quantum);
+    } else if (precision != "double") {
+      mem3dg_runtime_error("Unknown precision " + precision + " of variable " +
+                           var.getName());
+    }
+  }
+
   /**
    * @brief Private constructor for opening or creating a new NetCDF file.
    *
@@ -644,9 +965,6 @@ private:
    * @brief Initialize a new file with the given conventions
    */
   void initializeConventions() {
-
-    const int compression_level = 5;
-
     // initialize data
     fd->putAtt(CONVENTIONS_NAME, CONVENTIONS_VALUE);
     fd->putAtt(CONVENTIONS_VERSION_NAME, CONVENTIONS_VERSION_VALUE);
@@ -655,44 +973,53 @@ private:
     traj_group = fd->addGroup(TRAJ_GROUP_NAME);
 
     frame_dim = traj_group.addDim(FRAME_NAME);
+    topoRevision_dim = traj_group.addDim(TOPO_REVISION_NAME);
 
-    time_var = traj_group.addVar(TIME_VAR, netCDF::ncDouble, {frame_dim});
+    time_var = addVar(TIME_VAR, nc::ncDouble, settings.time);
     time_var.putAtt(UNITS, TIME_UNITS);
-    time_var.setCompression(true, true, compression_level);
 
     uint_array_t = traj_group.addVlenType(UINT_ARR, nc::ncUint);
     double_array_t = traj_group.addVlenType(DOUBLE_ARR, nc::ncDouble);
 
-    topo_var = traj_group.addVar(TOPO_VAR, uint_array_t, {frame_dim});
-    topo_var.setCompression(true, true, compression_level);
-    coord_var = traj_group.addVar(COORD_VAR, double_array_t, {frame_dim});
-    coord_var.setCompression(true, true, compression_level);
-    phi_var = traj_group.addVar(PHI_VAR, double_array_t, {frame_dim});
-    phi_var.setCompression(true, true, compression_level);
-    vel_var = traj_group.addVar(VEL_VAR, double_array_t, {frame_dim});
-    vel_var.setCompression(true, true, compression_level);
-    extF_var = traj_group.addVar(EXTF_VAR, double_array_t, {frame_dim});
-    extF_var.setCompression(true, true, compression_level);
+    topo_var =
+        addVar(TOPO_VAR, uint_array_t, settings.topology, topoRevision_dim);
+    topoFrame_var = addVar(TOPO_FRAME_VAR, nc::ncUint, settings.topology);
+    coord_var = addVar(COORD_VAR, double_array_t, settings.coordinates);
+    phi_var = addVar(PHI_VAR, double_array_t, settings.proteinDensity);
+    vel_var = addVar(VEL_VAR, double_array_t, settings.velocity);
+    extF_var = addVar(EXTF_VAR, double_array_t, settings.externalForce);
   }
 
   /// Bound NcFile
   NcFile *fd;
+  /// Conventions version of the bound file
+  std::string conventionsVersion = CONVENTIONS_VERSION_VALUE;
 
   nc::NcGroup parameter_group;
   nc::NcGroup traj_group;
 
   // Save dimensions
   nc::NcDim frame_dim;
+  /// Dimension of distinct topologies
+  nc::NcDim topoRevision_dim;
 
   /// Variable length type for topology
   nc::NcVlenType uint_array_t;
   nc::NcVlenType double_array_t;
+  /// Variable length types of reduced precision, only defined when used
+  nc::NcVlenType float_array_t;
+  nc::NcVlenType int_array_t;
 
   /// Variable for storing time
   nc::NcVar time_var;
 
-  /// Vlen variable for topology
+  /// Vlen variable for topology, indexed by revision if topoFrame_var exists
   nc::NcVar topo_var;
+  /// Variable for the topology revision of each frame
+  nc::NcVar topoFrame_var;
+  /// Last written topology and its revision
+  EigenVectorX3ur lastTopology;
+  std::size_t lastRevision = 0;
   /// Vlen variable for coordinates
   nc::NcVar coord_var;
   /// Vlen variable for protein density
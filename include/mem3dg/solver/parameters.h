@@ -136,6 +136,15 @@ struct Parameters {
     std::size_t n = 1;
     // period factor of computation
     double p = 0;
+    /// interaction range beyond the limit distance d, 0 to include all pairs
+    double r = 0;
+    /// skin distance of the neighbor list beyond the cutoff d + r
+    double skin = 0;
+
+    /**
+     * @brief check parameter conflicts
+     */
+    void checkParameters();
   };
 
   struct External {
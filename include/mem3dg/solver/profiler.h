@@ -0,0 +1,151 @@
+// Membrane Dynamics in 3D using Discrete Differential Geometry (Mem3DG)
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright (c) 2020:
+//     Laboratory for Computational Cellular Mechanobiology
+//     Cuncheng Zhu (cuzhu@eng.ucsd.edu)
+//     Christopher T. Lee (ctlee@ucsd.edu)
+//     Ravi Ramamoorthi (ravir@cs.ucsd.edu)
+//     Padmini Rangamani (prangamani@eng.ucsd.edu)
+//
+
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <string>
+
+#include "mem3dg/macros.h"
+
+namespace mem3dg {
+namespace solver {
+
+/**
+ * @brief Accumulated wall time of the phases and counts of the events of a
+ * simulation. Phases and events are interned ids indexing fixed arrays, so
+ * recording is cheap enough for the hot loops. Disabled by default
+ */
+class DLL_PUBLIC Profiler {
+public:
+  /// timed phases
+  enum PhaseId {
+    UpdateConfigurations,
+    RefreshGeometry,
+    UpdateGeodesics,
+    ComputePhysicalForcing,
+    ComputeMechanicalForces,
+    ComputeChemicalPotentials,
+    ComputeSelfAvoidanceForce,
+    ComputeDPDForces,
+    PrescribeExternalForce,
+    ComputePotentialEnergy,
+    EvaluatePotentialEnergy,
+    LineSearchTrial,
+    MutateMesh,
+    SmoothenMesh,
+    SaveData,
+    SaveMutableNetcdfData,
+    nPhases
+  };
+
+  /// counted events
+  enum CounterId {
+    EnergyEvaluations,
+    LineSearches,
+    LineSearchTrials,
+    EdgeFlips,
+    EdgeSplits,
+    EdgeCollapses,
+    nCounters
+  };
+
+  /// names of the phases, in the order of PhaseId
+  static const std::array<const char *, nPhases> phaseNames;
+  /// names of the counters, in the order of CounterId
+  static const std::array<const char *, nCounters> counterNames;
+
+  struct Phase {
+    /// number of timed calls
+    std::size_t nCalls = 0;
+    /// accumulated wall time (s)
+    double time = 0;
+  };
+
+  /**
+   * @brief Time the enclosing scope as one call of the phase
+   */
+  class ScopedTimer {
+  public:
+    ScopedTimer(Profiler &profiler_, PhaseId id_)
+        : profiler(profiler_), id(id_), isActive(profiler_.isEnabled) {
+      if (isActive)
+        start = std::chrono::steady_clock::now();
+    }
+    ~ScopedTimer() {
+      if (!isActive)
+        return;
+      Phase &phase = profiler.phases[id];
+      phase.time += std::chrono::duration<double>(
+                        std::chrono::steady_clock::now() - start)
+                        .count();
+      ++phase.nCalls;
+    }
+    ScopedTimer(const ScopedTimer &) = delete;
+    ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+  private:
+    Profiler &profiler;
+    PhaseId id;
+    bool isActive;
+    std::chrono::steady_clock::time_point start;
+  };
+
+  /// whether to record timing and counts
+  bool isEnabled = false;
+  /// timed phases by PhaseId
+  std::array<Phase, nPhases> phases{};
+  /// event counters by CounterId
+  std::array<std::size_t, nCounters> counters{};
+
+  /**
+   * @brief Add n events to the counter
+   */
+  void count(CounterId id, std::size_t n = 1) {
+    if (isEnabled)
+      counters[id] += n;
+  }
+
+  /**
+   * @brief Clear all phases and counters
+   */
+  void reset();
+
+  /**
+   * @brief Accumulated wall time (s) of each phase by name
+   */
+  std::map<std::string, double> getTiming() const;
+
+  /**
+   * @brief Count of each event by name
+   */
+  std::map<std::string, std::size_t> getCounts() const;
+
+  /**
+   * @brief Print the call count and time of each phase and the counters
+   */
+  void summarize() const;
+
+  /**
+   * @brief Write the phases and counters to a JSON file
+   */
+  void writeJson(const std::string &fileName) const;
+};
+
+} // namespace solver
+} // namespace mem3dg
@@ -31,8 +31,12 @@
 #include <pcg_random.hpp>
 #include <random>
 
+#include <array>
 #include <functional>
+#include <map>
 #include <math.h>
+#include <memory>
+#include <string>
 #include <vector>
 
 #include "geometrycentral/surface/halfedge_element_types.h"
@@ -44,9 +48,15 @@
 #include "mem3dg/macros.h"
 #include "mem3dg/mesh_io.h"
 #include "mem3dg/meshops.h"
+#include "mem3dg/solver/cell_list.h"
+#include "mem3dg/solver/cotan_laplacian.h"
 #include "mem3dg/solver/forces.h"
+#include "mem3dg/solver/geodesic_solver.h"
+#include "mem3dg/solver/geometry_refresh.h"
 #include "mem3dg/solver/mesh_process.h"
 #include "mem3dg/solver/parameters.h"
+#include "mem3dg/solver/profiler.h"
+#include "mem3dg/solver/topology_cache.h"
 #include "mem3dg/type_utilities.h"
 
 namespace gc = ::geometrycentral;
@@ -147,6 +157,47 @@ public:
   gcs::VertexData<bool> thePointTracker;
   /// projected time of collision
   double projectedCollideTime;
+  /// number of threads used in per-vertex force assembly (1: serial)
+  std::size_t nThreads;
+  /// Flat one-ring connectivity, rebuilt when topology changes
+  MeshTopologyCache topologyCache;
+  /// Selective refresh of the GC quantities needed by the parameters
+  GeometryRefreshPlanner geometryRefreshPlanner;
+  /// Timing of the simulation phases and counts of events
+  Profiler profiler;
+  /// Cotan Laplacian updated in place, pattern rebuilt when topology changes
+  CotanLaplacianAssembler cotanLaplacianAssembler;
+  /// Heat method geodesic distance reusing its factorization
+  GeodesicSolver geodesicSolver;
+  /// Cell list of vertex positions for self-avoidance neighbor search
+  CellList cellList;
+  /// CSR offsets of self-avoidance neighbors (j > i) of each vertex
+  std::vector<std::size_t> selfAvoidanceNeighborOffsets;
+  /// Self-avoidance neighbors within cutoff + skin, excluding the n-ring
+  std::vector<std::size_t> selfAvoidanceNeighbors;
+  /// Vertex positions at the last self-avoidance neighbor list build
+  EigenVectorX3dr selfAvoidanceReferencePositions;
+  /// Whether the self-avoidance neighbor list is outdated by topology change
+  bool isSelfAvoidanceNeighborsStale;
+  /// CSR offsets of self-avoidance candidate pairs (j > i) of energy trials
+  std::vector<std::size_t> trialPairOffsets;
+  /// Self-avoidance candidate pairs of energy trials, including the n-ring
+  std::vector<std::size_t> trialPairNeighbors;
+  /// Vertex positions the trial candidate pairs are found at
+  EigenVectorX3dr trialPairReferencePositions;
+  /// Distance within which the trial candidate pairs are found
+  double trialPairCutoff = 0;
+  /// Cached halfedge area gradient (twice the mean curvature vector)
+  gcs::HalfedgeData<gc::Vector3> halfedgeAreaGradient;
+  /// Cached halfedge Gaussian curvature vector
+  gcs::HalfedgeData<gc::Vector3> halfedgeGaussianCurvatureVector;
+  /// Cached halfedge volume variation vector
+  gcs::HalfedgeData<gc::Vector3> halfedgeVolumeVariationVector;
+  /// Cached edge length weighted dihedral angle gradient wrt he.vertex()
+  gcs::HalfedgeData<gc::Vector3> halfedgeSchlafliTailVector;
+  /// Cached edge length weighted dihedral angle gradient wrt the vertex
+  /// opposite to he in he.face()
+  gcs::HalfedgeData<gc::Vector3> halfedgeSchlafliOppositeVector;
 
   // ==========================================================
   // =============        Constructors           ==============
@@ -495,27 +546,25 @@ private:
     geodesicDistanceFromPtInd = gcs::VertexData<double>(*mesh, 0);
 
     isSmooth = true;
+    nThreads = 1;
+    halfedgeAreaGradient = gcs::HalfedgeData<gc::Vector3>(*mesh, {0, 0, 0});
+    halfedgeGaussianCurvatureVector =
+        gcs::HalfedgeData<gc::Vector3>(*mesh, {0, 0, 0});
+    halfedgeVolumeVariationVector =
+        gcs::HalfedgeData<gc::Vector3>(*mesh, {0, 0, 0});
+    halfedgeSchlafliTailVector =
+        gcs::HalfedgeData<gc::Vector3>(*mesh, {0, 0, 0});
+    halfedgeSchlafliOppositeVector =
+        gcs::HalfedgeData<gc::Vector3>(*mesh, {0, 0, 0});
+    topologyCache.build(*mesh);
+    cotanLaplacianAssembler.buildPattern(topologyCache);
+    isSelfAvoidanceNeighborsStale = true;
     mutationMarker = gc::VertexData<bool>(*mesh, false);
     thePointTracker = gc::VertexData<bool>(*mesh, false);
 
-    // GC computed properties
-    vpg->requireFaceNormals();
-    vpg->requireVertexLumpedMassMatrix();
-    vpg->requireCotanLaplacian();
-    vpg->requireFaceAreas();
-    vpg->requireVertexIndices();
-    vpg->requireVertexGaussianCurvatures();
-    vpg->requireVertexMeanCurvatures();
-    vpg->requireFaceIndices();
-    vpg->requireEdgeLengths();
-    vpg->requireVertexNormals();
-    vpg->requireVertexDualAreas();
-    vpg->requireCornerAngles();
-    vpg->requireCornerScaledAngles();
-    vpg->requireDECOperators();
-    vpg->requireEdgeDihedralAngles();
-    vpg->requireHalfedgeCotanWeights();
-    vpg->requireEdgeCotanWeights();
+    // GC computed properties needed by the default parameters, re-planned
+    // on each refresh
+    geometryRefreshPlanner.plan(parameters, *vpg);
     // vpg->requireVertexTangentBasis();
   }
 
@@ -527,25 +576,7 @@ public:
    * is another pointer to the HalfEdgeMesh and VertexPositionGeometry
    * elsewhere, calculation of dependent quantities should be respected.
    */
-  ~System() {
-    vpg->unrequireFaceNormals();
-    vpg->unrequireVertexLumpedMassMatrix();
-    vpg->unrequireCotanLaplacian();
-    vpg->unrequireFaceAreas();
-    vpg->unrequireVertexIndices();
-    vpg->unrequireVertexGaussianCurvatures();
-    vpg->unrequireVertexMeanCurvatures();
-    vpg->unrequireFaceIndices();
-    vpg->unrequireEdgeLengths();
-    vpg->unrequireVertexNormals();
-    vpg->unrequireVertexDualAreas();
-    vpg->unrequireCornerAngles();
-    vpg->unrequireCornerScaledAngles();
-    vpg->unrequireDECOperators();
-    vpg->unrequireEdgeDihedralAngles();
-    vpg->unrequireHalfedgeCotanWeights();
-    vpg->unrequireEdgeCotanWeights();
-  }
+  ~System() { geometryRefreshPlanner.release(*vpg); }
 
   // ==========================================================
   // ================          I/O           ==================
@@ -582,6 +613,41 @@ public:
    */
   void saveRichData(std::string PathToSave, bool isJustGeometry = false);
 
+  /**
+   * @brief Save the state of the system to a versioned binary checkpoint.
+   * The file is written next to the target and renamed, so a preempted write
+   * never leaves a partial checkpoint.
+   *
+   * @param fileName          Path to the checkpoint
+   * @param integratorCounters Counters of the integrator to restart with
+   * @param integratorArrays  State vectors of the integrator to restart with
+   */
+  void saveCheckpoint(const std::string &fileName,
+                      const std::map<std::string, double> &integratorCounters =
+                          std::map<std::string, double>(),
+                      const std::map<std::string, EigenVectorX1d>
+                          &integratorArrays =
+                              std::map<std::string, EigenVectorX1d>()) const;
+
+  /**
+   * @brief Construct a System from a checkpoint, skipping the reference
+   * initialization, geodesic solve and mesh smoothing of the other
+   * constructors
+   *
+   * @param fileName          Path to the checkpoint
+   * @param p                 Parameter of simulation
+   * @param mp                Setting for mesh processing
+   * @param integratorCounters Counters of the integrator in the checkpoint,
+   * ignored if null
+   * @param integratorArrays  State vectors of the integrator in the
+   * checkpoint, ignored if null
+   */
+  static std::unique_ptr<System>
+  loadCheckpoint(const std::string &fileName, Parameters &p, MeshProcessor &mp,
+                 std::map<std::string, double> *integratorCounters = nullptr,
+                 std::map<std::string, EigenVectorX1d> *integratorArrays =
+                     nullptr);
+
 #ifdef MEM3DG_WITH_NETCDF
   /**
    * @brief Construct a tuple of unique_ptrs from netcdf path
@@ -632,6 +698,32 @@ public:
    */
   void updateConfigurations(bool isUpdateGeodesics = false);
 
+  /**
+   * @brief Recompute the GC quantities needed by the current parameters
+   * after the vertex positions changed
+   */
+  void refreshGeometry();
+
+  /**
+   * @brief Compute the protein density dependent spontaneous curvature,
+   * bending rigidity and deviatoric rigidity
+   */
+  void computeProteinDependentModuli(
+      const Eigen::Matrix<double, Eigen::Dynamic, 1> &protein,
+      Eigen::Matrix<double, Eigen::Dynamic, 1> &H0_,
+      Eigen::Matrix<double, Eigen::Dynamic, 1> &Kb_,
+      Eigen::Matrix<double, Eigen::Dynamic, 1> &Kd_) const;
+
+  /**
+   * @brief Compute the global surface tension of the total surface area
+   */
+  double computeSurfaceTension(double area) const;
+
+  /**
+   * @brief Compute the global osmotic pressure of the enclosed volume
+   */
+  double computeOsmoticPressure(double volume) const;
+
   // ==========================================================
   // ================   Variational vectors  ==================
   // ==========================================================
@@ -692,6 +784,13 @@ public:
   computeHalfedgeSchlafliVector(gcs::VertexPositionGeometry &vpg,
                                 gc::Halfedge &he);
 
+  /**
+   * @brief Populate the cached halfedge variational vectors (area gradient,
+   * Gaussian curvature vector, volume variation and Schlafli pieces), to be
+   * gathered vertexwise by computeMechanicalForces
+   */
+  void computeHalfedgeVariationalVectors();
+
   /**
    * @brief Helper functions to compute geometric derivatives
    */
@@ -707,6 +806,13 @@ public:
   void computePhysicalForcing();
   void computePhysicalForcing(double timeStep);
 
+  /**
+   * @brief Compute the diagnostic force decompositions and scalar projections
+   * of the current configuration, regardless of forces.isDiagnostic, without
+   * modifying the integrated forces
+   */
+  void computeForceDiagnostics();
+
   /**
    * @brief Compute chemical potential of the system
    */
@@ -718,12 +824,53 @@ public:
   void computeSelfAvoidanceForce();
 
   /**
-   * @brief Compute mechanical forces
+   * @brief Build the self-avoidance neighbor (Verlet) list within d + r + skin
+   * using the cell list
+   */
+  void updateSelfAvoidanceNeighbors();
+
+  /**
+   * @brief Rebuild the self-avoidance neighbor list only if the topology has
+   * changed or any vertex has moved more than half of the skin distance since
+   * the last build
+   * @return whether the list is rebuilt
+   */
+  bool requireSelfAvoidanceNeighbors();
+
+  /**
+   * @brief Compute mechanical forces. The vertexwise overloads gather from the
+   * cached halfedge variational vectors, which need to be up to date (see
+   * computeHalfedgeVariationalVectors)
    */
   void computeMechanicalForces();
   void computeMechanicalForces(size_t i);
   void computeMechanicalForces(gcs::Vertex &v);
 
+  /// bitmask of the optional terms of the mechanical force kernel
+  enum MechanicalForceTerm : unsigned {
+    DeviatoricTerm = 1 << 0,
+    AdsorptionTerm = 1 << 1,
+    AggregationTerm = 1 << 2,
+    LineCapillaryTerm = 1 << 3,
+    AllTerms = (1 << 4) - 1
+  };
+
+  /**
+   * @brief Bitmask of the mechanical force terms enabled by the parameters
+   */
+  unsigned getMechanicalForceTerms() const;
+
+  /**
+   * @brief Vertexwise mechanical force kernel specialized on the bitmask of
+   * enabled terms. Forces of the disabled terms are set to zero
+   */
+  template <unsigned Terms> void computeMechanicalForcesKernel(size_t i);
+
+  /// kernel instantiations indexed by the bitmask of enabled terms
+  using MechanicalForceKernel = void (System::*)(size_t);
+  static const std::array<MechanicalForceKernel, AllTerms + 1>
+      mechanicalForceKernels;
+
   /**
    * @brief Compute external force component of the system
    */
@@ -742,12 +889,12 @@ public:
   // ================        Energy          ==================
   // ==========================================================
   /**
-   * @brief Compute bending energy
+   * @brief Compute bending energy, by the fused vertex pass
    */
   void computeBendingEnergy();
 
   /**
-   * @brief Compute deviatoric energy
+   * @brief Compute deviatoric energy, by the fused vertex pass
    */
   void computeDeviatoricEnergy();
 
@@ -762,22 +909,22 @@ public:
   void computePressureEnergy();
 
   /**
-   * @brief Compute adsorption energy
+   * @brief Compute adsorption energy, by the fused vertex pass
    */
   void computeAdsorptionEnergy();
 
   /**
-   * @brief Compute aggregation energy
+   * @brief Compute aggregation energy, by the fused vertex pass
    */
   void computeAggregationEnergy();
 
   /**
-   * @brief Compute protein interior penalty
+   * @brief Compute protein interior penalty, by the fused vertex pass
    */
   void computeProteinInteriorPenalty();
 
   /**
-   * @brief Compute Dirichlet energy
+   * @brief Compute Dirichlet energy, by the fused face pass
    */
   void computeDirichletEnergy();
 
@@ -786,6 +933,52 @@ public:
    */
   void computeSelfAvoidanceEnergy();
 
+  /**
+   * @brief Surface energy of the total surface area under surfaceTension
+   */
+  double computeSurfaceEnergy(double area, double surfaceTension) const;
+
+  /**
+   * @brief Pressure energy of the enclosed volume under osmoticPressure
+   */
+  double computePressureEnergy(double volume, double osmoticPressure) const;
+
+  /**
+   * @brief Fused pass over vertices for the bending, deviatoric, adsorption
+   * and aggregation energy and the protein interior penalty
+   *
+   * @param H       integrated mean curvature
+   * @param K       integrated Gaussian curvature, read if deviatoric
+   * @param A       vertex dual area
+   * @param phi     protein density
+   * @param H0_     spontaneous curvature
+   * @param Kb_     bending rigidity
+   * @param Kd_     deviatoric rigidity
+   * @param e       energy whose vertexwise terms are set
+   */
+  void computeVertexEnergies(const EigenVectorX1d &H, const EigenVectorX1d &K,
+                             const EigenVectorX1d &A, const EigenVectorX1d &phi,
+                             const EigenVectorX1d &H0_,
+                             const EigenVectorX1d &Kb_,
+                             const EigenVectorX1d &Kd_, Energy &e) const;
+
+  /**
+   * @brief Fused pass over vertices of the current configuration
+   */
+  void computeVertexEnergies(Energy &e) const;
+
+  /**
+   * @brief Dirichlet energy of the face gradient of the protein density
+   */
+  double computeDirichletEnergy(
+      const Eigen::Matrix<gc::Vector3, Eigen::Dynamic, 1> &gradient,
+      const EigenVectorX1d &faceAreas) const;
+
+  /**
+   * @brief Sum of the internal potential energy terms
+   */
+  static double sumPotentialEnergy(const Energy &e);
+
   /**
    * @brief Compute external work
    */
@@ -801,6 +994,22 @@ public:
    */
   double computePotentialEnergy();
 
+  /**
+   * @brief Evaluate the potential energy of a trial configuration without
+   * touching the geometry, forces or cached energy of the system. Meant for
+   * line search trials, external work is not included
+   */
+  double evaluatePotentialEnergy(const EigenVectorX3dr &positions,
+                                 const EigenVectorX1d &protein);
+
+  /**
+   * @brief Find the self-avoidance candidate pairs of all trial configurations
+   * within maxDisplacement of positions, so that evaluatePotentialEnergy does
+   * not rebuild a cell list for each of them
+   */
+  void reserveTrialPairs(const EigenVectorX3dr &positions,
+                         double maxDisplacement);
+
   /**
    * @brief compute total energy
    */
@@ -853,6 +1062,16 @@ public:
   void computeGradient(gcs::VertexData<double> &quantities,
                        gcs::FaceData<gc::Vector3> &gradient);
 
+  /**
+   * @brief Get gradient on a face of quantities q0, q1, q2 on its vertices at
+   * p0, p1, p2
+   */
+  static gc::Vector3 computeFaceGradient(const gc::Vector3 &normal,
+                                         double faceArea, const gc::Vector3 &p0,
+                                         const gc::Vector3 &p1,
+                                         const gc::Vector3 &p2, double q0,
+                                         double q1, double q2);
+
   /**
    * @brief Get gradient of quantities on face
    */
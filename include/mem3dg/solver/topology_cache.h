@@ -0,0 +1,131 @@
+// Membrane Dynamics in 3D using Discrete Differential Geometry (Mem3DG)
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright (c) 2020:
+//     Laboratory for Computational Cellular Mechanobiology
+//     Cuncheng Zhu (cuzhu@eng.ucsd.edu)
+//     Christopher T. Lee (ctlee@ucsd.edu)
+//     Ravi Ramamoorthi (ravir@cs.ucsd.edu)
+//     Padmini Rangamani (prangamani@eng.ucsd.edu)
+//
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <geometrycentral/surface/manifold_surface_mesh.h>
+
+#include "mem3dg/macros.h"
+
+namespace mem3dg {
+namespace solver {
+
+namespace gcs = ::geometrycentral::surface;
+
+/**
+ * @brief Flat (CSR) snapshot of the one-ring connectivity of a compressed mesh.
+ * Entries of vertex i are stored in [vertexOffsets[i], vertexOffsets[i + 1])
+ * in the order of gcs::Vertex::outgoingHalfedges(). Needs to be rebuilt
+ * whenever the mesh topology changes.
+ */
+struct DLL_PUBLIC MeshTopologyCache {
+  /// number of vertices of the snapshot
+  std::size_t nVertices = 0;
+  /// number of halfedges (including exterior) of the snapshot
+  std::size_t nHalfedges = 0;
+  /// number of faces of the snapshot
+  std::size_t nFaces = 0;
+
+  /// CSR offsets of the one-ring of each vertex, size nVertices + 1
+  std::vector<std::size_t> vertexOffsets;
+  /// outgoing halfedge index
+  std::vector<std::size_t> outgoingHalfedges;
+  /// one-ring neighbor (tip vertex of the outgoing halfedge)
+  std::vector<std::size_t> neighborVertices;
+  /// vertex opposite to the outgoing halfedge in its face (only valid if
+  /// interior)
+  std::vector<std::size_t> oppositeVertices;
+  /// face index of the outgoing halfedge (only valid if interior)
+  std::vector<std::size_t> faces;
+  /// edge index of the outgoing halfedge
+  std::vector<std::size_t> edges;
+  /// whether the outgoing halfedge is interior
+  std::vector<std::uint8_t> isInteriorHalfedge;
+  /// whether the edge of the outgoing halfedge is on the boundary
+  std::vector<std::uint8_t> isBoundaryEdge;
+
+  /// whether the vertex is on the boundary, size nVertices
+  std::vector<std::uint8_t> isBoundaryVertex;
+  /// next halfedge index, size nHalfedges
+  std::vector<std::size_t> halfedgeNext;
+  /// twin halfedge index, size nHalfedges
+  std::vector<std::size_t> halfedgeTwin;
+  /// tail vertex index, size nHalfedges
+  std::vector<std::size_t> halfedgeVertex;
+  /// face index (nFaces if exterior), size nHalfedges
+  std::vector<std::size_t> halfedgeFace;
+  /// vertex indices of each face in the order of its halfedges, size
+  /// 3 * nFaces
+  std::vector<std::size_t> faceVertices;
+
+  /// whether the n-ring exclusion sets are cached
+  bool hasRings = false;
+  /// layer of the cached n-ring exclusion sets
+  std::size_t ringLayer = 0;
+  /// CSR offsets of the n-ring of each vertex, size nVertices + 1
+  std::vector<std::size_t> ringOffsets;
+  /// sorted n-ring vertices (including the vertex itself)
+  std::vector<std::size_t> ringVertices;
+  /// number of vertices whose n-ring got recomputed in the last update
+  std::size_t nRingUpdates = 0;
+
+  /**
+   * @brief Rebuild the snapshot from mesh, which gets compressed if it is not.
+   * Cached n-rings are recomputed only for vertices whose neighborhood has
+   * changed, if the number of vertices stays the same
+   */
+  void build(gcs::ManifoldSurfaceMesh &mesh);
+
+  /**
+   * @brief Make sure the n-ring exclusion sets of the given layer are cached
+   */
+  void requireRings(std::size_t layer);
+
+  /**
+   * @brief Whether vertex j is within the cached n-ring of vertex i
+   */
+  bool isInRing(std::size_t i, std::size_t j) const {
+    return std::binary_search(ringVertices.begin() + ringOffsets[i],
+                              ringVertices.begin() + ringOffsets[i + 1], j);
+  }
+
+  /**
+   * @brief Whether the snapshot is consistent in size with the mesh
+   */
+  bool isConsistent(const gcs::ManifoldSurfaceMesh &mesh) const {
+    return mesh.isCompressed() && mesh.nVertices() == nVertices &&
+           mesh.nHalfedges() == nHalfedges && mesh.nFaces() == nFaces;
+  }
+
+  /**
+   * @brief Collect the sorted indices of vertices within layer (<= 2) rings
+   * of vertex i, including i itself, consistent with
+   * MeshProcessor::MeshMutator::markVertices
+   */
+  void collectRing(std::size_t i, std::size_t layer,
+                   std::vector<std::size_t> &ring) const;
+
+  /// first CSR entry of vertex i
+  std::size_t begin(std::size_t i) const { return vertexOffsets[i]; }
+  /// one past the last CSR entry of vertex i
+  std::size_t end(std::size_t i) const { return vertexOffsets[i + 1]; }
+};
+
+} // namespace solver
+} // namespace mem3dg
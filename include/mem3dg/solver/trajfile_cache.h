@@ -0,0 +1,189 @@
+// Membrane Dynamics in 3D using Discrete Differential Geometry (Mem3DG)
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright (c) 2020:
+//     Laboratory for Computational Cellular Mechanobiology
+//     Cuncheng Zhu (cuzhu@eng.ucsd.edu)
+//     Christopher T. Lee (ctlee@ucsd.edu)
+//     Ravi Ramamoorthi (ravir@cs.ucsd.edu)
+//     Padmini Rangamani (prangamani@eng.ucsd.edu)
+//
+
+
+/**
+ * @file  trajfile_cache.h
+ * @brief Random access cache of mutable trajectory frames
+ *
+ */
+
+#pragma once
+
+#ifdef MEM3DG_WITH_NETCDF
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+#include "mem3dg/macros.h"
+#include "mem3dg/solver/mutable_trajfile.h"
+#include "mem3dg/type_utilities.h"
+
+namespace mem3dg {
+namespace solver {
+
+/**
+ * @brief Hash of a face-vertex topology matrix (64 bit FNV-1a)
+ */
+DLL_PUBLIC std::uint64_t hashTopology(const EigenVectorX3ur &topology);
+
+/**
+ * @brief Read-only cache of the frames of a mutable trajectory
+ *
+ * The most recently used frames are kept in memory and, if requested, the
+ * frames following the last requested one are read ahead on a background
+ * thread. Frames with the same connectivity share one topology matrix,
+ * identified by its hash. The NetCDF library is not thread safe, so
+ * prefetching is off by default and should only be enabled when no other
+ * NetCDF file is accessed during the lifetime of the cache.
+ */
+class DLL_PUBLIC TrajFrameCache {
+public:
+  /**
+   * @brief Frame of the trajectory
+   */
+  struct Frame {
+    /// time
+    double time = 0;
+    /// face-vertex topology, shared by frames with the same connectivity
+    std::shared_ptr<const EigenVectorX3ur> topology;
+    /// hash of the topology
+    std::uint64_t topologyHash = 0;
+    /// vertex coordinates
+    EigenVectorX3dr coordinates;
+    /// vertex velocity
+    EigenVectorX3dr velocity;
+    /// protein density
+    EigenVectorX1d proteinDensity;
+  };
+
+  /**
+   * @brief Open a trajectory for cached reading
+   *
+   * @param filename  Path to the trajectory
+   * @param capacity  Maximum number of frames kept in memory
+   * @param nPrefetch Number of frames read ahead of the last requested one,
+   *                  no background thread is started if zero
+   */
+  TrajFrameCache(const std::string &filename, std::size_t capacity = 64,
+                 std::size_t nPrefetch = 0);
+
+  /**
+   * @brief Stop the prefetching thread
+   */
+  ~TrajFrameCache();
+
+  TrajFrameCache(const TrajFrameCache &) = delete;
+  TrajFrameCache &operator=(const TrajFrameCache &) = delete;
+
+  /**
+   * @brief Number of frames in the trajectory
+   */
+  std::size_t nFrames() const { return nFrames_; }
+
+  /**
+   * @brief Get a frame, reading it if not cached, and prefetch the following
+   * frames
+   *
+   * @param idx Index of the frame
+   */
+  std::shared_ptr<const Frame> getFrame(std::size_t idx);
+
+  /// Get the time of a frame
+  double getTime(std::size_t idx) { return getFrame(idx)->time; }
+  /// Get the topology of a frame
+  EigenVectorX3ur getTopology(std::size_t idx) {
+    return *getFrame(idx)->topology;
+  }
+  /// Get the topology hash of a frame
+  std::uint64_t getTopologyHash(std::size_t idx) {
+    return getFrame(idx)->topologyHash;
+  }
+  /// Get the coordinates of a frame
+  EigenVectorX3dr getCoords(std::size_t idx) {
+    return getFrame(idx)->coordinates;
+  }
+  /// Get the velocity of a frame
+  EigenVectorX3dr getVelocity(std::size_t idx) {
+    return getFrame(idx)->velocity;
+  }
+  /// Get the protein density of a frame
+  EigenVectorX1d getProteinDensity(std::size_t idx) {
+    return getFrame(idx)->proteinDensity;
+  }
+
+  /// Number of requests served from the cache
+  std::size_t nHits = 0;
+  /// Number of requests read from the file
+  std::size_t nMisses = 0;
+
+private:
+  /// Read a frame from the file
+  std::shared_ptr<const Frame> readFrame(std::size_t idx);
+  /// Look up a cached frame and mark it most recently used, requires the lock
+  std::shared_ptr<const Frame> findFrame(std::size_t idx);
+  /// Cache a frame and evict the least recently used, requires the lock
+  void insertFrame(std::size_t idx, std::shared_ptr<const Frame> frame);
+  /// Queue the frames following idx for prefetching
+  void schedulePrefetch(std::size_t idx);
+  /// Loop of the prefetching thread
+  void run();
+
+  /// Trajectory file, only accessed under fileMutex
+  MutableTrajFile file;
+  std::mutex fileMutex;
+  std::size_t nFrames_;
+  std::size_t capacity;
+  std::size_t nPrefetch;
+
+  /// Frame indices from most to least recently used
+  std::list<std::size_t> recency;
+  /// Cached frames and their position in recency
+  std::unordered_map<std::size_t,
+                     std::pair<std::shared_ptr<const Frame>,
+                               std::list<std::size_t>::iterator>>
+      frames;
+  /// Topologies of the cached frames by hash
+  std::map<std::uint64_t, std::weak_ptr<const EigenVectorX3ur>> topologies;
+  /// Topologies and their hash of the cached frames by topology revision
+  std::map<std::size_t,
+           std::pair<std::weak_ptr<const EigenVectorX3ur>, std::uint64_t>>
+      revisions;
+  /// Frames being read
+  std::set<std::size_t> loading;
+  /// Frames to prefetch
+  std::deque<std::size_t> prefetchQueue;
+  bool isStopping = false;
+
+  std::mutex mutex;
+  /// Signaled when a frame has been read
+  std::condition_variable frameLoaded;
+  /// Signaled when prefetching is requested or the cache is closing
+  std::condition_variable prefetchRequested;
+  std::thread worker;
+};
+
+} // namespace solver
+} // namespace mem3dg
+#endif
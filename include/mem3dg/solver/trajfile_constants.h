@@ -36,6 +36,8 @@ static const std::string SPATIAL_DIMS_NAME = "spatial";
 static const std::size_t SPATIAL_DIMS = 3;
 /// Name of frames
 static const std::string FRAME_NAME = "frame";
+/// Name of distinct topologies
+static const std::string TOPO_REVISION_NAME = "topologyrevision";
 /// nvertices
 static const std::string NVERTICES_NAME = "nvertices";
 /// nconers
@@ -47,8 +49,12 @@ static const std::string CONVENTIONS_NAME = "Conventions";
 static const std::string CONVENTIONS_VALUE = "Mem3DG";
 /// Conventions version
 static const std::string CONVENTIONS_VERSION_NAME = "ConventionsVersion";
-/// Conventions version value
-static const std::string CONVENTIONS_VERSION_VALUE = "0.0.1";
+/// Conventions version value, 0.0.2 stores each distinct topology of a
+/// mutable trajectory once, indexed by the topology revision of each frame
+static const std::string CONVENTIONS_VERSION_VALUE = "0.0.2";
+/// Previous conventions version value, still read, storing the topology of
+/// every frame
+static const std::string CONVENTIONS_VERSION_LEGACY_VALUE = "0.0.1";
 
 static const std::string PARAM_GROUP_NAME = "Parameters";
 static const std::string TRAJ_GROUP_NAME = "Trajectory";
@@ -71,7 +77,7 @@ static const std::string ISSMOOTH_VAR = "issmooth";
 static const std::string COORD_VAR = "coordinates";
 /// Name of the mesh topology data
 static const std::string TOPO_VAR = "topology";
-/// Name of the mesh topology data
+/// Name of the topology revision referenced by each frame
 static const std::string TOPO_FRAME_VAR = "topologyframe";
 /// Name of the mesh corner angle data
 static const std::string ANGLE_VAR = "angle";
@@ -148,6 +154,15 @@ static const std::string H_H0_VAR = "curvaturediff";
 static const std::string UINT_ARR = "uint_array";
 /// Name of double array vlen type
 static const std::string DOUBLE_ARR = "double_array";
+/// Name of float array vlen type
+static const std::string FLOAT_ARR = "float_array";
+/// Name of integer array vlen type, used by fixed precision variables
+static const std::string INT_ARR = "int_array";
+
+/// Attribute of the storage precision of a variable
+static const std::string PRECISION = "precision";
+/// Attribute of the quantum of fixed precision variables
+static const std::string SCALE_FACTOR = "scale_factor";
 
 #endif
 } // namespace solver
@@ -162,6 +162,9 @@ void play(polyscope::SurfaceMesh *&polyscopeMesh, mem3dg::solver::TrajFile &fd,
 void play(polyscope::SurfaceMesh *&polyscopeMesh,
           mem3dg::solver::MutableTrajFile &fd, int &idx, int &waitTime,
           const Quantities options, bool &toggle);
+void play(polyscope::SurfaceMesh *&polyscopeMesh,
+          mem3dg::solver::TrajFrameCache &cache, int &idx, int &waitTime,
+          const Quantities options, bool &toggle);
 
 /**
  * @brief Register Polyscope surface mesh from certain frame of the NetCDF
@@ -171,4 +174,11 @@ polyscope::SurfaceMesh *registerSurfaceMesh(mem3dg::solver::TrajFile &fd,
                                             int idx, const Quantities &options);
 polyscope::SurfaceMesh *registerSurfaceMesh(mem3dg::solver::MutableTrajFile &fd,
                                             int idx, const Quantities &options);
+/**
+ * @brief Register Polyscope surface mesh from a cached trajectory frame, only
+ * the vertex positions are updated if the topology is unchanged
+ */
+polyscope::SurfaceMesh *
+registerSurfaceMesh(mem3dg::solver::TrajFrameCache &cache, int idx,
+                    const Quantities &options);
 #endif
@@ -125,6 +125,34 @@ PYBIND11_MODULE(_core, pymem3dg) {
                                R"delim(
            verbosity level of integrator
       )delim");
+  velocityverlet.def_readwrite("isWriteProfile",
+                               &VelocityVerlet::isWriteProfile,
+                               R"delim(
+          write the profile to profile.json in the output directory
+      )delim");
+  velocityverlet.def_readwrite("isAsyncWrite", &VelocityVerlet::isAsyncWrite,
+                               R"delim(
+          write the trajectory frames on a background thread
+      )delim");
+  velocityverlet.def_readwrite("isWriteCheckpoint",
+                               &VelocityVerlet::isWriteCheckpoint,
+                               R"delim(
+          write a restart checkpoint to the output directory on every save
+      )delim");
+  velocityverlet.def(
+      "restoreCheckpoint", &VelocityVerlet::restoreCheckpoint,
+      py::arg("counters"),
+      py::arg("arrays") = std::map<std::string, EigenVectorX1d>(),
+      R"delim(
+          restore the integrator state returned by System.loadCheckpoint
+      )delim");
+#ifdef MEM3DG_WITH_NETCDF
+  velocityverlet.def_readwrite("trajFileSettings",
+                               &VelocityVerlet::trajFileSettings,
+                               R"delim(
+          compression, chunking and precision of the trajectory variables
+      )delim");
+#endif
 
   velocityverlet.def("integrate", &VelocityVerlet::integrate,
                      R"delim(
@@ -209,10 +237,38 @@ PYBIND11_MODULE(_core, pymem3dg) {
                       R"delim(
            save .ply with just geometry
       )delim");
+  euler.def_readwrite("isWriteProfile", &Euler::isWriteProfile,
+                      R"delim(
+          write the profile to profile.json in the output directory
+      )delim");
+  euler.def_readwrite("isAsyncWrite", &Euler::isAsyncWrite,
+                      R"delim(
+          write the trajectory frames on a background thread
+      )delim");
+  euler.def_readwrite("isWriteCheckpoint", &Euler::isWriteCheckpoint,
+                      R"delim(
+          write a restart checkpoint to the output directory on every save
+      )delim");
+  euler.def("restoreCheckpoint", &Euler::restoreCheckpoint, py::arg("counters"),
+            py::arg("arrays") = std::map<std::string, EigenVectorX1d>(),
+            R"delim(
+          restore the integrator state returned by System.loadCheckpoint
+      )delim");
+#ifdef MEM3DG_WITH_NETCDF
+  euler.def_readwrite("trajFileSettings", &Euler::trajFileSettings,
+                      R"delim(
+          compression, chunking and precision of the trajectory variables
+      )delim");
+#endif
   euler.def_readwrite("isBacktrack", &Euler::isBacktrack,
                       R"delim(
          whether do backtracking line search
       )delim");
+  euler.def_readwrite("isInterpolatingLineSearch",
+                      &Euler::isInterpolatingLineSearch,
+                      R"delim(
+          whether choose line search steps by quadratic/cubic interpolation
+      )delim");
   euler.def_readwrite("rho", &Euler::rho,
                       R"delim(
           backtracking coefficient
@@ -246,6 +302,11 @@ PYBIND11_MODULE(_core, pymem3dg) {
             R"delim(
           step for n iterations
       )delim");
+  euler.def("getAverageEnergyEvaluations",
+            &Euler::getAverageEnergyEvaluations,
+            R"delim(
+          get the average number of energy evaluations per line search
+      )delim");
 
   // ==========================================================
   // =============     Conjugate Gradient       ===============
@@ -318,11 +379,45 @@ PYBIND11_MODULE(_core, pymem3dg) {
                                   R"delim(
            save .ply with just geometry
       )delim");
+  conjugategradient.def_readwrite("isWriteProfile",
+                                  &ConjugateGradient::isWriteProfile,
+                                  R"delim(
+          write the profile to profile.json in the output directory
+      )delim");
+  conjugategradient.def_readwrite("isAsyncWrite",
+                                  &ConjugateGradient::isAsyncWrite,
+                                  R"delim(
+          write the trajectory frames on a background thread
+      )delim");
+  conjugategradient.def_readwrite("isWriteCheckpoint",
+                                  &ConjugateGradient::isWriteCheckpoint,
+                                  R"delim(
+          write a restart checkpoint to the output directory on every save
+      )delim");
+  conjugategradient.def(
+      "restoreCheckpoint", &ConjugateGradient::restoreCheckpoint,
+      py::arg("counters"),
+      py::arg("arrays") = std::map<std::string, EigenVectorX1d>(),
+      R"delim(
+          restore the integrator state returned by System.loadCheckpoint
+      )delim");
+#ifdef MEM3DG_WITH_NETCDF
+  conjugategradient.def_readwrite("trajFileSettings",
+                                  &ConjugateGradient::trajFileSettings,
+                                  R"delim(
+          compression, chunking and precision of the trajectory variables
+      )delim");
+#endif
   conjugategradient.def_readwrite("isBacktrack",
                                   &ConjugateGradient::isBacktrack,
                                   R"delim(
          whether do backtracking line search
       )delim");
+  conjugategradient.def_readwrite("isInterpolatingLineSearch",
+                                  &ConjugateGradient::isInterpolatingLineSearch,
+                                  R"delim(
+          whether choose line search steps by quadratic/cubic interpolation
+      )delim");
   conjugategradient.def_readwrite("rho", &ConjugateGradient::rho,
                                   R"delim(
           backtracking coefficient
@@ -371,6 +466,11 @@ PYBIND11_MODULE(_core, pymem3dg) {
                         R"delim(
           step for n iterations
       )delim");
+  conjugategradient.def("getAverageEnergyEvaluations",
+                        &ConjugateGradient::getAverageEnergyEvaluations,
+                        R"delim(
+          get the average number of energy evaluations per line search
+      )delim");
 
   // ==========================================================
   // =============            BFGS              ===============
@@ -413,6 +513,294 @@ PYBIND11_MODULE(_core, pymem3dg) {
           step for n iterations
       )delim");
 
+  // ==========================================================
+  // =============           L-BFGS             ===============
+  // ==========================================================
+  py::class_<LBFGS> lbfgs(pymem3dg, "LBFGS",
+                          R"delim(
+        limited-memory BFGS optimizer
+    )delim");
+
+  lbfgs.def(py::init<System &, double, double, double, double, std::string>(),
+            py::arg("system"), py::arg("characteristicTimeStep"),
+            py::arg("totalTime"), py::arg("savePeriod"), py::arg("tolerance"),
+            py::arg("outputDirectory"),
+            R"delim(
+        L-BFGS optimizer constructor
+      )delim");
+
+  /**
+   * @brief attributes, integration options
+   */
+  lbfgs.def_readonly("characteristicTimeStep", &LBFGS::characteristicTimeStep,
+                     R"delim(
+          characteristic time step
+      )delim");
+  lbfgs.def_readonly("totalTime", &LBFGS::totalTime,
+                     R"delim(
+          time limit
+      )delim");
+  lbfgs.def_readonly("savePeriod", &LBFGS::savePeriod,
+                     R"delim(
+         period of saving output data
+      )delim");
+  lbfgs.def_readonly("tolerance", &LBFGS::tolerance,
+                     R"delim(
+          tolerance for termination
+      )delim");
+  lbfgs.def_readwrite("updateGeodesicsPeriod", &LBFGS::updateGeodesicsPeriod,
+                      R"delim(
+          period of update geodesics
+      )delim");
+  lbfgs.def_readwrite("processMeshPeriod", &LBFGS::processMeshPeriod,
+                      R"delim(
+          period of processing mesh
+      )delim");
+  lbfgs.def_readwrite("trajFileName", &LBFGS::trajFileName,
+                      R"delim(
+          name of the trajectory file 
+      )delim");
+  lbfgs.def_readwrite("isAdaptiveStep", &LBFGS::isAdaptiveStep,
+                      R"delim(
+          option to scale time step according to mesh size
+      )delim");
+  lbfgs.def_readwrite("outputDirectory", &LBFGS::outputDirectory,
+                      R"delim(
+          path to the output directory
+      )delim");
+  lbfgs.def_readwrite("verbosity", &LBFGS::verbosity,
+                      R"delim(
+           verbosity level of integrator
+      )delim");
+  lbfgs.def_readwrite("isJustGeometryPly", &LBFGS::isJustGeometryPly,
+                      R"delim(
+           save .ply with just geometry
+      )delim");
+  lbfgs.def_readwrite("isWriteProfile", &LBFGS::isWriteProfile,
+                      R"delim(
+          write the profile to profile.json in the output directory
+      )delim");
+  lbfgs.def_readwrite("isAsyncWrite", &LBFGS::isAsyncWrite,
+                      R"delim(
+          write the trajectory frames on a background thread
+      )delim");
+  lbfgs.def_readwrite("isWriteCheckpoint", &LBFGS::isWriteCheckpoint,
+                      R"delim(
+          write a restart checkpoint to the output directory on every save
+      )delim");
+  lbfgs.def("restoreCheckpoint", &LBFGS::restoreCheckpoint, py::arg("counters"),
+            py::arg("arrays") = std::map<std::string, EigenVectorX1d>(),
+            R"delim(
+          restore the integrator state returned by System.loadCheckpoint
+      )delim");
+#ifdef MEM3DG_WITH_NETCDF
+  lbfgs.def_readwrite("trajFileSettings", &LBFGS::trajFileSettings,
+                      R"delim(
+          compression, chunking and precision of the trajectory variables
+      )delim");
+#endif
+  lbfgs.def_readwrite("historyLength", &LBFGS::historyLength,
+                      R"delim(
+          number of correction pairs kept for the inverse Hessian
+      )delim");
+  lbfgs.def_readwrite("isBacktrack", &LBFGS::isBacktrack,
+                      R"delim(
+         whether do backtracking line search
+      )delim");
+  lbfgs.def_readwrite("isInterpolatingLineSearch",
+                      &LBFGS::isInterpolatingLineSearch,
+                      R"delim(
+          whether choose line search steps by quadratic/cubic interpolation
+      )delim");
+  lbfgs.def_readwrite("rho", &LBFGS::rho,
+                      R"delim(
+          backtracking coefficient
+      )delim");
+  lbfgs.def_readwrite("c1", &LBFGS::c1,
+                      R"delim(
+          Wolfe condition parameter
+      )delim");
+  lbfgs.def_readwrite("constraintTolerance", &LBFGS::constraintTolerance,
+                      R"delim(
+            tolerance for constraints
+      )delim");
+  lbfgs.def_readwrite("isAugmentedLagrangian", &LBFGS::isAugmentedLagrangian,
+                      R"delim(
+            whether use augmented lagrangian method 
+      )delim");
+
+  /**
+   * @brief methods
+   */
+  lbfgs.def("integrate", &LBFGS::integrate,
+            R"delim(
+          integrate 
+      )delim");
+  lbfgs.def("status", &LBFGS::status,
+            R"delim(
+          status computation and thresholding
+      )delim");
+  lbfgs.def("march", &LBFGS::march,
+            R"delim(
+          stepping forward 
+      )delim");
+  lbfgs.def("saveData", &LBFGS::saveData,
+            R"delim(
+          save data to output directory
+      )delim");
+  lbfgs.def("step", &LBFGS::step, py::arg("n"),
+            R"delim(
+          step for n iterations
+      )delim");
+  lbfgs.def("getAverageEnergyEvaluations",
+            &LBFGS::getAverageEnergyEvaluations,
+            R"delim(
+          get the average number of energy evaluations per line search
+      )delim");
+
+  // ==========================================================
+  // =============           FIRE               ===============
+  // ==========================================================
+  py::class_<FIRE> fire(pymem3dg, "FIRE",
+                       R"delim(
+        fast inertial relaxation engine (FIRE) minimizer
+    )delim");
+
+  fire.def(py::init<System &, double, double, double, double, std::string>(),
+           py::arg("system"), py::arg("characteristicTimeStep"),
+           py::arg("totalTime"), py::arg("savePeriod"), py::arg("tolerance"),
+           py::arg("outputDirectory"),
+           R"delim(
+        FIRE minimizer constructor
+      )delim");
+
+  /**
+   * @brief attributes, integration options
+   */
+  fire.def_readonly("characteristicTimeStep", &FIRE::characteristicTimeStep,
+                    R"delim(
+          characteristic time step
+      )delim");
+  fire.def_readonly("totalTime", &FIRE::totalTime,
+                    R"delim(
+          time limit
+      )delim");
+  fire.def_readonly("savePeriod", &FIRE::savePeriod,
+                    R"delim(
+         period of saving output data
+      )delim");
+  fire.def_readonly("tolerance", &FIRE::tolerance,
+                    R"delim(
+          tolerance for termination
+      )delim");
+  fire.def_readwrite("updateGeodesicsPeriod", &FIRE::updateGeodesicsPeriod,
+                     R"delim(
+          period of update geodesics
+      )delim");
+  fire.def_readwrite("processMeshPeriod", &FIRE::processMeshPeriod,
+                     R"delim(
+          period of processing mesh
+      )delim");
+  fire.def_readwrite("trajFileName", &FIRE::trajFileName,
+                     R"delim(
+          name of the trajectory file 
+      )delim");
+  fire.def_readwrite("isAdaptiveStep", &FIRE::isAdaptiveStep,
+                     R"delim(
+          option to scale time step according to mesh size
+      )delim");
+  fire.def_readwrite("outputDirectory", &FIRE::outputDirectory,
+                     R"delim(
+          path to the output directory
+      )delim");
+  fire.def_readwrite("verbosity", &FIRE::verbosity,
+                     R"delim(
+           verbosity level of integrator
+      )delim");
+  fire.def_readwrite("isJustGeometryPly", &FIRE::isJustGeometryPly,
+                     R"delim(
+           save .ply with just geometry
+      )delim");
+  fire.def_readwrite("isWriteProfile", &FIRE::isWriteProfile,
+                     R"delim(
+          write the profile to profile.json in the output directory
+      )delim");
+  fire.def_readwrite("isAsyncWrite", &FIRE::isAsyncWrite,
+                     R"delim(
+          write the trajectory frames on a background thread
+      )delim");
+  fire.def_readwrite("isWriteCheckpoint", &FIRE::isWriteCheckpoint,
+                     R"delim(
+          write a restart checkpoint to the output directory on every save
+      )delim");
+  fire.def("restoreCheckpoint", &FIRE::restoreCheckpoint, py::arg("counters"),
+           py::arg("arrays") = std::map<std::string, EigenVectorX1d>(),
+           R"delim(
+          restore the integrator state returned by System.loadCheckpoint
+      )delim");
+#ifdef MEM3DG_WITH_NETCDF
+  fire.def_readwrite("trajFileSettings", &FIRE::trajFileSettings,
+                     R"delim(
+          compression, chunking and precision of the trajectory variables
+      )delim");
+#endif
+  fire.def_readwrite("maxTimeStepFactor", &FIRE::maxTimeStepFactor,
+                     R"delim(
+          maximum time step relative to the characteristic time step
+      )delim");
+  fire.def_readwrite("nDelay", &FIRE::nDelay,
+                     R"delim(
+          number of downhill steps before increasing the time step
+      )delim");
+  fire.def_readwrite("timeStepIncrease", &FIRE::timeStepIncrease,
+                     R"delim(
+          time step increase factor
+      )delim");
+  fire.def_readwrite("timeStepDecrease", &FIRE::timeStepDecrease,
+                     R"delim(
+          time step decrease factor on uphill steps
+      )delim");
+  fire.def_readwrite("initialMixing", &FIRE::initialMixing,
+                     R"delim(
+          initial velocity mixing coefficient
+      )delim");
+  fire.def_readwrite("mixingDecrease", &FIRE::mixingDecrease,
+                     R"delim(
+          velocity mixing coefficient decrease factor
+      )delim");
+  fire.def_readwrite("constraintTolerance", &FIRE::constraintTolerance,
+                     R"delim(
+            tolerance for constraints
+      )delim");
+  fire.def_readwrite("isAugmentedLagrangian", &FIRE::isAugmentedLagrangian,
+                     R"delim(
+            whether use augmented lagrangian method 
+      )delim");
+
+  /**
+   * @brief methods
+   */
+  fire.def("integrate", &FIRE::integrate,
+           R"delim(
+          integrate 
+      )delim");
+  fire.def("status", &FIRE::status,
+           R"delim(
+          status computation and thresholding
+      )delim");
+  fire.def("march", &FIRE::march,
+           R"delim(
+          stepping forward 
+      )delim");
+  fire.def("saveData", &FIRE::saveData,
+           R"delim(
+          save data to output directory
+      )delim");
+  fire.def("step", &FIRE::step, py::arg("n"),
+           R"delim(
+          step for n iterations
+      )delim");
+
 #pragma endregion integrators
 
 #pragma region forces
@@ -423,6 +811,12 @@ PYBIND11_MODULE(_core, pymem3dg) {
                             R"delim(
         The forces object
     )delim");
+  forces.def_readwrite("isDiagnostic", &Forces::isDiagnostic,
+                       R"delim(
+          whether to compute the diagnostic force decompositions and scalar
+          projections with the forces, turned off by integrators and
+          recomputed on save frames. While off, they are zeroed
+      )delim");
   forces.def(
       "getSurfaceTension", [](Forces &s) { return s.surfaceTension; },
       py::return_value_policy::copy,
@@ -773,6 +1167,181 @@ PYBIND11_MODULE(_core, pymem3dg) {
       )delim");
 #pragma endregion mesh_mutator
 
+  py::class_<GeodesicSolver> geodesicsolver(pymem3dg, "GeodesicSolver",
+                                            R"delim(
+        The heat method geodesic solver with reused factorization
+    )delim");
+  geodesicsolver.def_readwrite("tolerance", &GeodesicSolver::tolerance,
+                               R"delim(
+          get the relative geometric drift tolerance before refactorization,
+          0 (default) refactorizes on any vertex motion
+      )delim");
+  geodesicsolver.def_readonly("nHits", &GeodesicSolver::nHits,
+                              R"delim(
+          get the number of solves reusing the factorization
+      )delim");
+  geodesicsolver.def_readonly("nMisses", &GeodesicSolver::nMisses,
+                              R"delim(
+          get the number of solves that refactorized
+      )delim");
+
+  // ==========================================================
+  // =============          Profiler            ===============
+  // ==========================================================
+  py::class_<Profiler> profiler(pymem3dg, "Profiler",
+                                R"delim(
+        The timing of simulation phases and counts of events
+    )delim");
+  profiler.def_readwrite("isEnabled", &Profiler::isEnabled,
+                         R"delim(
+          whether to record timing and counts, off by default
+      )delim");
+  profiler.def_property_readonly("counters", &Profiler::getCounts,
+                                 R"delim(
+          get the event counters by name
+      )delim");
+  profiler.def("getTiming", &Profiler::getTiming,
+               R"delim(
+          get the accumulated time (s) of each phase
+      )delim");
+  profiler.def("summarize", &Profiler::summarize,
+               R"delim(
+          print the call count and time of each phase and the counters
+      )delim");
+  profiler.def("writeJson", &Profiler::writeJson, py::arg("fileName"),
+               R"delim(
+          write the phases and counters to a JSON file
+      )delim");
+  profiler.def("reset", &Profiler::reset,
+               R"delim(
+          clear all phases and counters
+      )delim");
+
+#ifdef MEM3DG_WITH_NETCDF
+  // ==========================================================
+  // =============    Trajectory settings       ===============
+  // ==========================================================
+  py::class_<TrajVariableSettings> trajVariableSettings(
+      pymem3dg, "TrajVariableSettings",
+      R"delim(
+        The storage settings of a trajectory variable
+    )delim");
+  py::enum_<TrajVariableSettings::Precision>(trajVariableSettings, "Precision")
+      .value("Double", TrajVariableSettings::Double)
+      .value("Float", TrajVariableSettings::Float)
+      .value("Fixed", TrajVariableSettings::Fixed)
+      .export_values();
+  trajVariableSettings.def(py::init<>());
+  trajVariableSettings.def_readwrite("compressionLevel",
+                                     &TrajVariableSettings::compressionLevel,
+                                     R"delim(
+          deflate level from 1 to 9, 0 disables compression
+      )delim");
+  trajVariableSettings.def_readwrite("isShuffle",
+                                     &TrajVariableSettings::isShuffle,
+                                     R"delim(
+          whether to shuffle the bytes before compression
+      )delim");
+  trajVariableSettings.def_readwrite("chunkSize",
+                                     &TrajVariableSettings::chunkSize,
+                                     R"delim(
+          number of frames per chunk, 0 for the library default
+      )delim");
+  trajVariableSettings.def_readwrite("precision",
+                                     &TrajVariableSettings::precision,
+                                     R"delim(
+          storage precision of floating point arrays: Double, Float or Fixed
+      )delim");
+  trajVariableSettings.def_readwrite("quantum", &TrajVariableSettings::quantum,
+                                     R"delim(
+          quantum of the Fixed precision
+      )delim");
+
+  py::class_<TrajFileSettings> trajFileSettings(pymem3dg, "TrajFileSettings",
+                                                R"delim(
+        The storage settings of the trajectory variables
+    )delim");
+  trajFileSettings.def(py::init<>());
+  trajFileSettings.def_readwrite("time", &TrajFileSettings::time,
+                                 R"delim(
+          settings of the time
+      )delim");
+  trajFileSettings.def_readwrite("topology", &TrajFileSettings::topology,
+                                 R"delim(
+          settings of the topology
+      )delim");
+  trajFileSettings.def_readwrite("coordinates", &TrajFileSettings::coordinates,
+                                 R"delim(
+          settings of the coordinates
+      )delim");
+  trajFileSettings.def_readwrite("velocity", &TrajFileSettings::velocity,
+                                 R"delim(
+          settings of the velocity
+      )delim");
+  trajFileSettings.def_readwrite("proteinDensity",
+                                 &TrajFileSettings::proteinDensity,
+                                 R"delim(
+          settings of the protein density
+      )delim");
+  trajFileSettings.def_readwrite("externalForce",
+                                 &TrajFileSettings::externalForce,
+                                 R"delim(
+          settings of the external force
+      )delim");
+
+  py::class_<TrajFrameCache> trajFrameCache(pymem3dg, "TrajFrameCache",
+                                            R"delim(
+        Random access reader of a mutable trajectory that caches the recently
+        used frames and optionally prefetches the following ones
+    )delim");
+  trajFrameCache.def(
+      py::init<const std::string &, std::size_t, std::size_t>(),
+      py::arg("trajFile"), py::arg("capacity") = 64, py::arg("nPrefetch") = 0,
+      R"delim(
+          open a trajectory for cached reading
+      )delim");
+  trajFrameCache.def("nFrames", &TrajFrameCache::nFrames,
+                     R"delim(
+          get the number of frames
+      )delim");
+  trajFrameCache.def("getTime", &TrajFrameCache::getTime, py::arg("frame"),
+                     R"delim(
+          get the time of a frame
+      )delim");
+  trajFrameCache.def("getTopology", &TrajFrameCache::getTopology,
+                     py::arg("frame"),
+                     R"delim(
+          get the face-vertex topology of a frame
+      )delim");
+  trajFrameCache.def("getTopologyHash", &TrajFrameCache::getTopologyHash,
+                     py::arg("frame"),
+                     R"delim(
+          get the topology hash of a frame, equal for unchanged connectivity
+      )delim");
+  trajFrameCache.def("getCoords", &TrajFrameCache::getCoords, py::arg("frame"),
+                     R"delim(
+          get the vertex coordinates of a frame
+      )delim");
+  trajFrameCache.def("getVelocity", &TrajFrameCache::getVelocity,
+                     py::arg("frame"),
+                     R"delim(
+          get the vertex velocity of a frame
+      )delim");
+  trajFrameCache.def("getProteinDensity", &TrajFrameCache::getProteinDensity,
+                     py::arg("frame"),
+                     R"delim(
+          get the protein density of a frame
+      )delim");
+  trajFrameCache.def_readonly("nHits", &TrajFrameCache::nHits,
+                              R"delim(
+          get the number of frames served from the cache
+      )delim");
+  trajFrameCache.def_readonly("nMisses", &TrajFrameCache::nMisses,
+                              R"delim(
+          get the number of frames read from the file
+      )delim");
+#endif
+
 #pragma region system
   // ==========================================================
   // =============          System              ===============
@@ -874,10 +1443,22 @@ PYBIND11_MODULE(_core, pymem3dg) {
                        R"delim(
           get the mesh processor object
       )delim");
+  system.def_readonly("geodesicSolver", &System::geodesicSolver,
+                      R"delim(
+          get the geodesic solver
+      )delim");
+  system.def_readwrite("profiler", &System::profiler,
+                       R"delim(
+          get the profiler
+      )delim");
   system.def_readwrite("time", &System::time,
                        R"delim(
           get the time
       )delim");
+  system.def_readwrite("nThreads", &System::nThreads,
+                       R"delim(
+          get the number of threads used in force assembly (requires OpenMP)
+      )delim");
 
   /**
    * @brief    Geometric properties (Geometry central)
@@ -892,13 +1473,24 @@ PYBIND11_MODULE(_core, pymem3dg) {
       )delim");
   system.def(
       "getLumpedMassMatrix",
-      [](System &s) { return s.vpg->vertexLumpedMassMatrix; },
+      [](System &s) {
+        s.vpg->requireVertexLumpedMassMatrix();
+        Eigen::SparseMatrix<double> M = s.vpg->vertexLumpedMassMatrix;
+        s.vpg->unrequireVertexLumpedMassMatrix();
+        return M;
+      },
       py::return_value_policy::copy,
       R"delim(
           get the lumped mass matrix of the mesh
       )delim");
   system.def(
-      "getCotanLaplacian", [](System &s) { return s.vpg->cotanLaplacian; },
+      "getCotanLaplacian",
+      [](System &s) {
+        s.vpg->requireCotanLaplacian();
+        Eigen::SparseMatrix<double> L = s.vpg->cotanLaplacian;
+        s.vpg->unrequireCotanLaplacian();
+        return L;
+      },
       py::return_value_policy::copy,
       R"delim(
           get the Cotan Laplacian matrix of the mesh
@@ -927,13 +1519,25 @@ PYBIND11_MODULE(_core, pymem3dg) {
           get the face vertex matrix
       )delim");
   system.def(
-      "getVertexAdjacencyMatrix", [](System &s) { return s.vpg->d0; },
+      "getVertexAdjacencyMatrix",
+      [](System &s) {
+        s.vpg->requireDECOperators();
+        Eigen::SparseMatrix<double> d0 = s.vpg->d0;
+        s.vpg->unrequireDECOperators();
+        return d0;
+      },
       py::return_value_policy::copy,
       R"delim(
           get the signed E-V vertex adjacency matrix, equivalent of d0 operator
       )delim");
   system.def(
-      "getEdgeAdjacencyMatrix", [](System &s) { return s.vpg->d1; },
+      "getEdgeAdjacencyMatrix",
+      [](System &s) {
+        s.vpg->requireDECOperators();
+        Eigen::SparseMatrix<double> d1 = s.vpg->d1;
+        s.vpg->unrequireDECOperators();
+        return d1;
+      },
       py::return_value_policy::copy,
       R"delim(
           get the signed F-E edge adjacency matrix, equivalent of d1 operator
@@ -945,11 +1549,20 @@ PYBIND11_MODULE(_core, pymem3dg) {
       R"delim(
           get vertex dual area
       )delim");
+  system.def(
+      "getGeometryRefreshTiming",
+      [](System &s) { return s.geometryRefreshPlanner.getTiming(); },
+      py::return_value_policy::copy,
+      R"delim(
+          get the accumulated time (s) spent refreshing each geometric quantity
+      )delim");
   system.def(
       "getMeanCurvature",
       [](System &s) {
         s.vpg->requireVertexMeanCurvatures();
-        return s.vpg->vertexMeanCurvatures.raw();
+        EigenVectorX1d H = s.vpg->vertexMeanCurvatures.raw();
+        s.vpg->unrequireVertexMeanCurvatures();
+        return H;
       },
       py::return_value_policy::copy,
       R"delim(
@@ -959,7 +1572,9 @@ PYBIND11_MODULE(_core, pymem3dg) {
       "getGaussianCurvature",
       [](System &s) {
         s.vpg->requireVertexGaussianCurvatures();
-        return s.vpg->vertexGaussianCurvatures.raw();
+        EigenVectorX1d K = s.vpg->vertexGaussianCurvatures.raw();
+        s.vpg->unrequireVertexGaussianCurvatures();
+        return K;
       },
       py::return_value_policy::copy,
       R"delim(
@@ -1047,6 +1662,11 @@ PYBIND11_MODULE(_core, pymem3dg) {
       R"delim(
             compute all the forces
         )delim");
+  system.def("computeForceDiagnostics", &System::computeForceDiagnostics,
+             R"delim(
+            compute the diagnostic force decompositions and scalar
+            projections without modifying the integrated forces
+        )delim");
   //   system.def("computeBendingForce", &System::computeBendingForce,
   //              py::return_value_policy::copy,
   //              R"delim(
@@ -1121,6 +1741,28 @@ PYBIND11_MODULE(_core, pymem3dg) {
              R"delim(
           save snapshot data to directory
       )delim");
+  system.def("saveCheckpoint", &System::saveCheckpoint, py::arg("fileName"),
+             py::arg("integratorCounters") = std::map<std::string, double>(),
+             py::arg("integratorArrays") =
+                 std::map<std::string, EigenVectorX1d>(),
+             R"delim(
+          save the state to a binary checkpoint for restart
+      )delim");
+  system.def_static(
+      "loadCheckpoint",
+      [](const std::string &fileName, Parameters &p, MeshProcessor &mp) {
+        std::map<std::string, double> integratorCounters;
+        std::map<std::string, EigenVectorX1d> integratorArrays;
+        std::unique_ptr<System> system = System::loadCheckpoint(
+            fileName, p, mp, &integratorCounters, &integratorArrays);
+        return std::make_tuple(std::move(system), integratorCounters,
+                               integratorArrays);
+      },
+      py::arg("fileName"), py::arg("p"), py::arg("mp"),
+      R"delim(
+          construct the system from a checkpoint, returns the system and the
+          integrator counters and arrays
+      )delim");
 
   /**
    * @brief Method: mutate the mesh
@@ -1336,6 +1978,15 @@ PYBIND11_MODULE(_core, pymem3dg) {
                               R"delim(
           get the period factor of self-avoidance computation
       )delim");
+  selfAvoidance.def_readwrite("r", &Parameters::SelfAvoidance::r,
+                              R"delim(
+          get the interaction range beyond the limit distance, 0 to include
+          all pairs
+      )delim");
+  selfAvoidance.def_readwrite("skin", &Parameters::SelfAvoidance::skin,
+                              R"delim(
+          get the skin distance of the self-avoidance neighbor list
+      )delim");
 
   py::class_<Parameters::Point> point(pymem3dg, "Point",
                                       R"delim(
@@ -0,0 +1,139 @@
+// Membrane Dynamics in 3D using Discrete Differential Geometry (Mem3DG)
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright (c) 2020:
+//     Laboratory for Computational Cellular Mechanobiology
+//     Cuncheng Zhu (cuzhu@eng.ucsd.edu)
+//     Christopher T. Lee (ctlee@ucsd.edu)
+//     Ravi Ramamoorthi (ravir@cs.ucsd.edu)
+//     Padmini Rangamani (prangamani@eng.ucsd.edu)
+//
+
+
+/**
+ * @file  async_trajfile_writer.cpp
+ * @brief Asynchronous output of mutable trajectory frames
+ *
+ */
+
+#ifdef MEM3DG_WITH_NETCDF
+
+#include <algorithm>
+#include <iostream>
+
+#include "mem3dg/solver/async_trajfile_writer.h"
+
+namespace mem3dg {
+namespace solver {
+
+void TrajFrame::write(MutableTrajFile &file, const std::size_t idx) const {
+  // same order as Integrator::saveMutableNetcdfData
+  file.writeTime(idx, time);
+  file.writeVelocity(idx, velocity);
+  if (hasExternalForce)
+    file.writeExternalForce(idx, externalForce);
+  file.writeCoords(idx, coordinates);
+  file.writeTopology(idx, topology);
+  file.writeProteinDensity(idx, proteinDensity);
+  file.sync();
+}
+
+AsyncTrajFileWriter::AsyncTrajFileWriter(MutableTrajFile &file_,
+                                         std::size_t queueDepth)
+    : AsyncTrajFileWriter(file_, queueDepth, file_.nFrames()) {}
+
+AsyncTrajFileWriter::AsyncTrajFileWriter(MutableTrajFile &file_,
+                                         std::size_t queueDepth,
+                                         std::size_t firstIndex)
+    : file(file_), buffers(std::max<std::size_t>(queueDepth, 1)),
+      nextIndex(firstIndex) {
+  worker = std::thread(&AsyncTrajFileWriter::run, this);
+}
+
+AsyncTrajFileWriter::~AsyncTrajFileWriter() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    isStopping = true;
+  }
+  frameSubmitted.notify_one();
+  worker.join();
+  if (error) {
+    try {
+      std::rethrow_exception(error);
+    } catch (const std::exception &e) {
+      std::cerr << "Failed to write trajectory frame: " << e.what()
+                << std::endl;
+    }
+  }
+}
+
+TrajFrame &AsyncTrajFileWriter::acquireFrame() {
+  std::unique_lock<std::mutex> lock(mutex);
+  if (isAcquired)
+    mem3dg_runtime_error("Previous frame has not been submitted!");
+  frameWritten.wait(lock, [this] { return nPending < buffers.size(); });
+  rethrowError();
+  isAcquired = true;
+  return buffers[(head + nPending) % buffers.size()];
+}
+
+void AsyncTrajFileWriter::submitFrame() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!isAcquired)
+      mem3dg_runtime_error("No frame has been acquired!");
+    isAcquired = false;
+    ++nPending;
+    ++nSubmittedFrames;
+  }
+  frameSubmitted.notify_one();
+}
+
+void AsyncTrajFileWriter::flush() {
+  std::unique_lock<std::mutex> lock(mutex);
+  frameWritten.wait(lock, [this] { return nPending == 0; });
+  rethrowError();
+}
+
+void AsyncTrajFileWriter::rethrowError() {
+  if (error) {
+    std::exception_ptr e = error;
+    error = nullptr;
+    std::rethrow_exception(e);
+  }
+}
+
+void AsyncTrajFileWriter::run() {
+  std::unique_lock<std::mutex> lock(mutex);
+  for (;;) {
+    frameSubmitted.wait(lock, [this] { return nPending > 0 || isStopping; });
+    if (nPending == 0)
+      return;
+
+    // the buffer at head is not handed out until it is released below
+    const TrajFrame &frame = buffers[head];
+    lock.unlock();
+    std::exception_ptr writeError;
+    try {
+      frame.write(file, nextIndex);
+    } catch (...) {
+      writeError = std::current_exception();
+    }
+    lock.lock();
+
+    if (writeError && !error)
+      error = writeError;
+    ++nextIndex;
+    head = (head + 1) % buffers.size();
+    --nPending;
+    frameWritten.notify_all();
+  }
+}
+
+} // namespace solver
+} // namespace mem3dg
+
+#endif
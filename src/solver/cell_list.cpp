@@ -0,0 +1,137 @@
+// Membrane Dynamics in 3D using Discrete Differential Geometry (Mem3DG)
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright (c) 2020:
+//     Laboratory for Computational Cellular Mechanobiology
+//     Cuncheng Zhu (cuzhu@eng.ucsd.edu)
+//     Christopher T. Lee (ctlee@ucsd.edu)
+//     Ravi Ramamoorthi (ravir@cs.ucsd.edu)
+//     Padmini Rangamani (prangamani@eng.ucsd.edu)
+//
+
+#include "mem3dg/solver/cell_list.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace mem3dg {
+namespace solver {
+
+/// Upper limit of the number of cells along an axis, so that the cell key
+/// nx * ny * nz fits in 64 bits
+static const std::int64_t MAX_CELLS_PER_AXIS = std::int64_t(1) << 20;
+
+std::int64_t CellList::cellCoordinate(double x, double x0,
+                                      std::int64_t n) const {
+  std::int64_t c = static_cast<std::int64_t>(std::floor((x - x0) / gridSize));
+  return std::min(std::max(c, std::int64_t(0)), n - 1);
+}
+
+void CellList::build(const Eigen::Ref<const EigenVectorX3dr> &positions,
+                     double cellSize_) {
+  if (!(cellSize_ > 0)) {
+    mem3dg_runtime_error("Cell size of the cell list has to be positive!");
+  }
+  cellSize = cellSize_;
+  gridSize = cellSize_;
+  sortedIndices.clear();
+  cellRanges.clear();
+  std::size_t nPoints = positions.rows();
+  if (nPoints == 0) {
+    nx = ny = nz = 0;
+    return;
+  }
+  if (!positions.allFinite()) {
+    mem3dg_runtime_error("Cell list positions have to be finite!");
+  }
+
+  // bounding box of the grid, coarsened if the cells are too many to key
+  origin = positions.colwise().minCoeff();
+  Eigen::RowVector3d extent = positions.colwise().maxCoeff() - origin;
+  if (extent.maxCoeff() / gridSize >= MAX_CELLS_PER_AXIS - 1)
+    gridSize = extent.maxCoeff() / (MAX_CELLS_PER_AXIS - 2);
+  nx = static_cast<std::int64_t>(std::floor(extent[0] / gridSize)) + 1;
+  ny = static_cast<std::int64_t>(std::floor(extent[1] / gridSize)) + 1;
+  nz = static_cast<std::int64_t>(std::floor(extent[2] / gridSize)) + 1;
+
+  // sort points by cell key
+  std::vector<std::pair<std::int64_t, std::size_t>> keys(nPoints);
+  for (std::size_t i = 0; i < nPoints; ++i) {
+    std::int64_t cx = cellCoordinate(positions(i, 0), origin[0], nx);
+    std::int64_t cy = cellCoordinate(positions(i, 1), origin[1], ny);
+    std::int64_t cz = cellCoordinate(positions(i, 2), origin[2], nz);
+    keys[i] = std::make_pair(cx + nx * (cy + ny * cz), i);
+  }
+  std::sort(keys.begin(), keys.end());
+
+  // range of each nonempty cell
+  sortedIndices.resize(nPoints);
+  std::size_t start = 0;
+  for (std::size_t k = 0; k < nPoints; ++k) {
+    sortedIndices[k] = keys[k].second;
+    if (k + 1 == nPoints || keys[k + 1].first != keys[k].first) {
+      cellRanges[keys[k].first] = std::make_pair(start, k + 1);
+      start = k + 1;
+    }
+  }
+}
+
+void CellList::findCandidates(
+    const Eigen::Ref<const Eigen::RowVector3d> &position,
+    std::vector<std::size_t> &candidates) const {
+  if (sortedIndices.empty())
+    return;
+  if (!position.allFinite()) {
+    mem3dg_runtime_error("Cell list position has to be finite!");
+  }
+  std::int64_t cx = cellCoordinate(position[0], origin[0], nx);
+  std::int64_t cy = cellCoordinate(position[1], origin[1], ny);
+  std::int64_t cz = cellCoordinate(position[2], origin[2], nz);
+  for (std::int64_t z = std::max(cz - 1, std::int64_t(0));
+       z <= std::min(cz + 1, nz - 1); ++z) {
+    for (std::int64_t y = std::max(cy - 1, std::int64_t(0));
+         y <= std::min(cy + 1, ny - 1); ++y) {
+      for (std::int64_t x = std::max(cx - 1, std::int64_t(0));
+           x <= std::min(cx + 1, nx - 1); ++x) {
+        auto cell = cellRanges.find(x + nx * (y + ny * z));
+        if (cell == cellRanges.end())
+          continue;
+        candidates.insert(candidates.end(),
+                          sortedIndices.begin() + cell->second.first,
+                          sortedIndices.begin() + cell->second.second);
+      }
+    }
+  }
+}
+
+void CellList::findPairs(const Eigen::Ref<const EigenVectorX3dr> &positions,
+                         double cutoff, std::vector<std::size_t> &offsets,
+                         std::vector<std::size_t> &neighbors) const {
+  if (cutoff > cellSize) {
+    mem3dg_runtime_error("Cutoff can not exceed the cell size!");
+  }
+  std::size_t nPoints = positions.rows();
+  const double cutoff2 = cutoff * cutoff;
+  offsets.assign(nPoints + 1, 0);
+  neighbors.clear();
+  std::vector<std::size_t> candidates;
+  for (std::size_t i = 0; i < nPoints; ++i) {
+    candidates.clear();
+    findCandidates(positions.row(i), candidates);
+    std::size_t start = neighbors.size();
+    for (std::size_t j : candidates) {
+      if (j > i &&
+          (positions.row(j) - positions.row(i)).squaredNorm() < cutoff2) {
+        neighbors.push_back(j);
+      }
+    }
+    std::sort(neighbors.begin() + start, neighbors.end());
+    offsets[i + 1] = neighbors.size();
+  }
+}
+
+} // namespace solver
+} // namespace mem3dg
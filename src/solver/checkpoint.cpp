@@ -0,0 +1,392 @@
+// Membrane Dynamics in 3D using Discrete Differential Geometry (Mem3DG)
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright (c) 2020:
+//     Laboratory for Computational Cellular Mechanobiology
+//     Cuncheng Zhu (cuzhu@eng.ucsd.edu)
+//     Christopher T. Lee (ctlee@ucsd.edu)
+//     Ravi Ramamoorthi (ravir@cs.ucsd.edu)
+//     Padmini Rangamani (prangamani@eng.ucsd.edu)
+//
+
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <geometrycentral/surface/surface_point.h>
+
+#include "mem3dg/macros.h"
+#include "mem3dg/solver/system.h"
+#include "mem3dg/type_utilities.h"
+
+namespace gc = ::geometrycentral;
+namespace gcs = ::geometrycentral::surface;
+
+namespace mem3dg {
+namespace solver {
+
+namespace {
+/*
+ * Checkpoint layout, all sections start at a multiple of 8 bytes so the file
+ * can be mapped and read in place:
+ *
+ *   CheckpointHeader
+ *   uint32  face-vertex topology      [nFaces x 3]
+ *   double  vertex positions          [nVertices x 3]
+ *   double  vertex velocity           [nVertices x 3]
+ *   double  protein density           [nVertices]
+ *   double  protein velocity          [nVertices]
+ *   double  external force            [nVertices x 3]
+ *   double  force mask                [nVertices x 3]
+ *   double  protein mask              [nVertices]
+ *   double  geodesic distance         [nVertices]
+ *   uint8   "the point" tracker       [nVertices]
+ *   if HasSelfAvoidanceNeighbors:
+ *     double  reference positions     [nVertices x 3]
+ *     uint64  neighbor offsets        [nVertices + 1]
+ *     uint64  neighbors               [nSelfAvoidanceNeighbors]
+ *   char    random engine state       [rngStateSize]
+ *   CheckpointCounter                 [nCounters]
+ *   nArrays times:
+ *     CheckpointArray
+ *     double  values                  [size]
+ */
+const char CHECKPOINT_MAGIC[8] = {'M', '3', 'D', 'G', 'C', 'K', 'P', 'T'};
+const std::uint32_t CHECKPOINT_VERSION = 1;
+const std::uint32_t CHECKPOINT_BYTE_ORDER = 0x01020304;
+
+enum CheckpointFlags : std::uint32_t {
+  IsSmooth = 1 << 0,
+  HasSelfAvoidanceNeighbors = 1 << 1
+};
+
+struct CheckpointHeader {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t byteOrder;
+  std::uint64_t nVertices;
+  std::uint64_t nFaces;
+  std::uint64_t nSelfAvoidanceNeighbors;
+  std::uint64_t rngStateSize;
+  std::uint64_t nCounters;
+  std::uint64_t nArrays;
+  double time;
+  double surfaceArea;
+  double volume;
+  /// barycentric coordinates of "the point" on a face, or the edge parameter
+  double thePointCoords[3];
+  /// index of the vertex, edge or face of "the point"
+  std::uint64_t thePointElement;
+  /// gcs::SurfacePointType of "the point"
+  std::uint32_t thePointType;
+  std::uint32_t flags;
+};
+static_assert(sizeof(CheckpointHeader) % 8 == 0,
+              "Checkpoint header has to keep the sections aligned");
+
+struct CheckpointCounter {
+  char name[56];
+  double value;
+};
+
+struct CheckpointArray {
+  char name[56];
+  std::uint64_t size;
+};
+
+/// Copy a name into a fixed size, null terminated field
+void writeName(char (&field)[56], const std::string &name) {
+  if (name.size() >= sizeof(field))
+    mem3dg_runtime_error("Checkpoint entry name " + name + " is too long!");
+  std::memset(field, 0, sizeof(field));
+  std::memcpy(field, name.data(), name.size());
+}
+
+std::size_t paddedSize(std::size_t nBytes) { return (nBytes + 7) / 8 * 8; }
+
+/**
+ * @brief Append aligned sections to a checkpoint
+ */
+class CheckpointWriter {
+public:
+  explicit CheckpointWriter(std::ofstream &file_) : file(file_) {}
+
+  void write(const void *data, std::size_t nBytes) {
+    static const char padding[8] = {};
+    file.write(static_cast<const char *>(data), nBytes);
+    file.write(padding, paddedSize(nBytes) - nBytes);
+  }
+
+  template <typename T> void write(const std::vector<T> &data) {
+    write(data.data(), data.size() * sizeof(T));
+  }
+
+private:
+  std::ofstream &file;
+};
+
+/**
+ * @brief Bounds checked sequential access to the sections of a checkpoint
+ */
+class CheckpointReader {
+public:
+  explicit CheckpointReader(std::vector<char> &&buffer_)
+      : buffer(std::move(buffer_)) {}
+
+  template <typename T> const T *read(std::size_t count) {
+    std::size_t nBytes = count * sizeof(T);
+    if (offset + nBytes > buffer.size())
+      mem3dg_runtime_error("Checkpoint is truncated!");
+    const T *data = reinterpret_cast<const T *>(buffer.data() + offset);
+    offset += paddedSize(nBytes);
+    return data;
+  }
+
+private:
+  std::vector<char> buffer;
+  std::size_t offset = 0;
+};
+} // namespace
+
+void System::saveCheckpoint(
+    const std::string &fileName,
+    const std::map<std::string, double> &integratorCounters,
+    const std::map<std::string, EigenVectorX1d> &integratorArrays) const {
+  const std::size_t nVertices = mesh->nVertices();
+  const bool hasNeighbors = !isSelfAvoidanceNeighborsStale &&
+                            selfAvoidanceNeighborOffsets.size() ==
+                                nVertices + 1 &&
+                            selfAvoidanceReferencePositions.rows() ==
+                                static_cast<Eigen::Index>(nVertices);
+
+  std::ostringstream rngState;
+  rngState << rng;
+
+  CheckpointHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic));
+  header.version = CHECKPOINT_VERSION;
+  header.byteOrder = CHECKPOINT_BYTE_ORDER;
+  header.nVertices = nVertices;
+  header.nFaces = mesh->nFaces();
+  header.nSelfAvoidanceNeighbors =
+      hasNeighbors ? selfAvoidanceNeighbors.size() : 0;
+  header.rngStateSize = rngState.str().size();
+  header.nCounters = integratorCounters.size();
+  header.nArrays = integratorArrays.size();
+  header.time = time;
+  header.surfaceArea = surfaceArea;
+  header.volume = volume;
+  header.thePointType = static_cast<std::uint32_t>(thePoint.type);
+  switch (thePoint.type) {
+  case gcs::SurfacePointType::Vertex:
+    header.thePointElement = thePoint.vertex.getIndex();
+    break;
+  case gcs::SurfacePointType::Edge:
+    header.thePointElement = thePoint.edge.getIndex();
+    header.thePointCoords[0] = thePoint.tEdge;
+    break;
+  case gcs::SurfacePointType::Face:
+    header.thePointElement = thePoint.face.getIndex();
+    header.thePointCoords[0] = thePoint.faceCoords.x;
+    header.thePointCoords[1] = thePoint.faceCoords.y;
+    header.thePointCoords[2] = thePoint.faceCoords.z;
+    break;
+  }
+  header.flags = (isSmooth ? IsSmooth : 0) |
+                 (hasNeighbors ? HasSelfAvoidanceNeighbors : 0);
+
+  // write next to the target and rename once complete
+  const std::string partialFileName = fileName + ".partial";
+  std::ofstream file(partialFileName, std::ios::binary | std::ios::trunc);
+  if (!file)
+    mem3dg_runtime_error("Cannot open " + partialFileName + " for writing!");
+  CheckpointWriter writer(file);
+  writer.write(&header, sizeof(header));
+
+  EigenVectorX3ur faceVertices = mesh->getFaceVertexMatrix<std::uint32_t>();
+  writer.write(faceVertices.data(),
+               faceVertices.size() * sizeof(std::uint32_t));
+  EigenVectorX3dr vectors = toMatrix(vpg->inputVertexPositions);
+  writer.write(vectors.data(), vectors.size() * sizeof(double));
+  vectors = gc::EigenMap<double, 3>(velocity);
+  writer.write(vectors.data(), vectors.size() * sizeof(double));
+  writer.write(proteinDensity.raw().data(), nVertices * sizeof(double));
+  writer.write(proteinVelocity.raw().data(), nVertices * sizeof(double));
+  vectors = gc::EigenMap<double, 3>(forces.externalForceVec);
+  writer.write(vectors.data(), vectors.size() * sizeof(double));
+  vectors = gc::EigenMap<double, 3>(forces.forceMask);
+  writer.write(vectors.data(), vectors.size() * sizeof(double));
+  writer.write(forces.proteinMask.raw().data(), nVertices * sizeof(double));
+  writer.write(geodesicDistanceFromPtInd.raw().data(),
+               nVertices * sizeof(double));
+  std::vector<std::uint8_t> tracker(nVertices);
+  for (std::size_t i = 0; i < nVertices; ++i)
+    tracker[i] = thePointTracker.raw()[i];
+  writer.write(tracker);
+
+  if (hasNeighbors) {
+    writer.write(selfAvoidanceReferencePositions.data(),
+                 selfAvoidanceReferencePositions.size() * sizeof(double));
+    writer.write(std::vector<std::uint64_t>(
+        selfAvoidanceNeighborOffsets.begin(),
+        selfAvoidanceNeighborOffsets.end()));
+    writer.write(std::vector<std::uint64_t>(selfAvoidanceNeighbors.begin(),
+                                            selfAvoidanceNeighbors.end()));
+  }
+
+  writer.write(rngState.str().data(), header.rngStateSize);
+
+  std::vector<CheckpointCounter> counters(integratorCounters.size());
+  std::size_t i = 0;
+  for (const auto &counter : integratorCounters) {
+    writeName(counters[i].name, counter.first);
+    counters[i].value = counter.second;
+    ++i;
+  }
+  writer.write(counters);
+
+  for (const auto &array : integratorArrays) {
+    CheckpointArray arrayHeader;
+    writeName(arrayHeader.name, array.first);
+    arrayHeader.size = array.second.size();
+    writer.write(&arrayHeader, sizeof(arrayHeader));
+    writer.write(array.second.data(), array.second.size() * sizeof(double));
+  }
+
+  file.close();
+  if (!file)
+    mem3dg_runtime_error("Failed to write checkpoint " + partialFileName);
+  if (std::rename(partialFileName.c_str(), fileName.c_str()) != 0)
+    mem3dg_runtime_error("Failed to move checkpoint to " + fileName);
+}
+
+std::unique_ptr<System>
+System::loadCheckpoint(
+    const std::string &fileName, Parameters &p, MeshProcessor &mp,
+    std::map<std::string, double> *integratorCounters,
+    std::map<std::string, EigenVectorX1d> *integratorArrays) {
+  std::ifstream file(fileName, std::ios::binary);
+  if (!file)
+    mem3dg_runtime_error("Cannot open checkpoint " + fileName);
+  CheckpointReader reader(
+      std::vector<char>((std::istreambuf_iterator<char>(file)),
+                        std::istreambuf_iterator<char>()));
+
+  const CheckpointHeader header = *reader.read<CheckpointHeader>(1);
+  if (std::memcmp(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic)) != 0)
+    mem3dg_runtime_error(fileName + " is not a Mem3DG checkpoint!");
+  if (header.version != CHECKPOINT_VERSION)
+    mem3dg_runtime_error("Unsupported checkpoint version " +
+                         std::to_string(header.version));
+  if (header.byteOrder != CHECKPOINT_BYTE_ORDER)
+    mem3dg_runtime_error("Checkpoint was written with a different byte order!");
+  const std::size_t nVertices = header.nVertices;
+  const std::size_t nFaces = header.nFaces;
+
+  // rebuild the mesh with the saved indexing
+  Eigen::Matrix<std::size_t, Eigen::Dynamic, 3> faceVertices =
+      Eigen::Map<const EigenVectorX3ur>(
+          reader.read<std::uint32_t>(3 * nFaces), nFaces, 3)
+          .cast<std::size_t>();
+  Eigen::Matrix<double, Eigen::Dynamic, 3> positions =
+      Eigen::Map<const EigenVectorX3dr>(reader.read<double>(3 * nVertices),
+                                        nVertices, 3);
+  std::unique_ptr<System> system(new System(
+      gcs::makeManifoldSurfaceMeshAndGeometry(positions, faceVertices), p,
+      mp));
+  System &f = *system;
+  f.checkConfiguration();
+
+  // map the state
+  toMatrix(f.velocity) = Eigen::Map<const EigenVectorX3dr>(
+      reader.read<double>(3 * nVertices), nVertices, 3);
+  f.proteinDensity.raw() = Eigen::Map<const EigenVectorX1d>(
+      reader.read<double>(nVertices), nVertices);
+  f.proteinVelocity.raw() = Eigen::Map<const EigenVectorX1d>(
+      reader.read<double>(nVertices), nVertices);
+  // otherwise only prescribed along with the geodesics
+  toMatrix(f.forces.externalForceVec) = Eigen::Map<const EigenVectorX3dr>(
+      reader.read<double>(3 * nVertices), nVertices, 3);
+  toMatrix(f.forces.forceMask) = Eigen::Map<const EigenVectorX3dr>(
+      reader.read<double>(3 * nVertices), nVertices, 3);
+  f.forces.proteinMask.raw() = Eigen::Map<const EigenVectorX1d>(
+      reader.read<double>(nVertices), nVertices);
+  f.geodesicDistanceFromPtInd.raw() = Eigen::Map<const EigenVectorX1d>(
+      reader.read<double>(nVertices), nVertices);
+  const std::uint8_t *tracker = reader.read<std::uint8_t>(nVertices);
+  for (std::size_t i = 0; i < nVertices; ++i)
+    f.thePointTracker.raw()[i] = tracker[i] != 0;
+
+  if (header.flags & HasSelfAvoidanceNeighbors) {
+    f.selfAvoidanceReferencePositions = Eigen::Map<const EigenVectorX3dr>(
+        reader.read<double>(3 * nVertices), nVertices, 3);
+    const std::uint64_t *offsets = reader.read<std::uint64_t>(nVertices + 1);
+    f.selfAvoidanceNeighborOffsets.assign(offsets, offsets + nVertices + 1);
+    const std::uint64_t *neighbors =
+        reader.read<std::uint64_t>(header.nSelfAvoidanceNeighbors);
+    f.selfAvoidanceNeighbors.assign(
+        neighbors, neighbors + header.nSelfAvoidanceNeighbors);
+    f.isSelfAvoidanceNeighborsStale = false;
+  }
+
+  std::istringstream rngState(std::string(
+      reader.read<char>(header.rngStateSize), header.rngStateSize));
+  rngState >> f.rng;
+
+  const CheckpointCounter *counters =
+      reader.read<CheckpointCounter>(header.nCounters);
+  if (integratorCounters != nullptr) {
+    integratorCounters->clear();
+    for (std::size_t i = 0; i < header.nCounters; ++i)
+      (*integratorCounters)[counters[i].name] = counters[i].value;
+  }
+  if (integratorArrays != nullptr)
+    integratorArrays->clear();
+  for (std::size_t i = 0; i < header.nArrays; ++i) {
+    const CheckpointArray arrayHeader = *reader.read<CheckpointArray>(1);
+    const double *values = reader.read<double>(arrayHeader.size);
+    if (integratorArrays != nullptr)
+      (*integratorArrays)[arrayHeader.name] =
+          Eigen::Map<const EigenVectorX1d>(values, arrayHeader.size);
+  }
+
+  f.time = header.time;
+  f.energy.time = header.time;
+  f.surfaceArea = header.surfaceArea;
+  f.volume = header.volume;
+  f.isSmooth = header.flags & IsSmooth;
+  switch (static_cast<gcs::SurfacePointType>(header.thePointType)) {
+  case gcs::SurfacePointType::Vertex:
+    f.thePoint = gcs::SurfacePoint(f.mesh->vertex(header.thePointElement));
+    break;
+  case gcs::SurfacePointType::Edge:
+    f.thePoint = gcs::SurfacePoint(f.mesh->edge(header.thePointElement),
+                                   header.thePointCoords[0]);
+    break;
+  case gcs::SurfacePointType::Face:
+    f.thePoint = gcs::SurfacePoint(
+        f.mesh->face(header.thePointElement),
+        gc::Vector3{header.thePointCoords[0], header.thePointCoords[1],
+                    header.thePointCoords[2]});
+    break;
+  default:
+    mem3dg_runtime_error("Checkpoint has an invalid surface point!");
+  }
+
+  // recompute the cached geometry without the geodesic solve
+  f.updateConfigurations(false);
+  return system;
+}
+
+} // namespace solver
+} // namespace mem3dg
@@ -0,0 +1,80 @@
+// Membrane Dynamics in 3D using Discrete Differential Geometry (Mem3DG)
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright (c) 2020:
+//     Laboratory for Computational Cellular Mechanobiology
+//     Cuncheng Zhu (cuzhu@eng.ucsd.edu)
+//     Christopher T. Lee (ctlee@ucsd.edu)
+//     Ravi Ramamoorthi (ravir@cs.ucsd.edu)
+//     Padmini Rangamani (prangamani@eng.ucsd.edu)
+//
+
+
+#include "mem3dg/solver/cotan_laplacian.h"
+
+#include <algorithm>
+
+namespace mem3dg {
+namespace solver {
+
+void CotanLaplacianAssembler::buildPattern(const MeshTopologyCache &topo) {
+  std::size_t n = topo.nVertices;
+
+  // symbolic pattern: diagonal and one-ring neighbors
+  std::vector<Eigen::Triplet<double>> tripletList;
+  tripletList.reserve(n + topo.neighborVertices.size());
+  for (std::size_t i = 0; i < n; ++i) {
+    tripletList.emplace_back(i, i, 0);
+    for (std::size_t k = topo.begin(i); k < topo.end(i); ++k) {
+      tripletList.emplace_back(topo.neighborVertices[k], i, 0);
+    }
+  }
+  matrix.resize(n, n);
+  matrix.setFromTriplets(tripletList.begin(), tripletList.end());
+  matrix.makeCompressed();
+
+  // position of entry (row, col) in the values of the compressed matrix
+  auto nonzero = [this](std::size_t row, std::size_t col) {
+    const auto *first = matrix.innerIndexPtr() + matrix.outerIndexPtr()[col];
+    const auto *last = matrix.innerIndexPtr() + matrix.outerIndexPtr()[col + 1];
+    using StorageIndex = Eigen::SparseMatrix<double>::StorageIndex;
+    const auto *it = std::lower_bound(first, last, StorageIndex(row));
+    if (it == last || *it != StorageIndex(row))
+      mem3dg_runtime_error("Entry is not in the cotan Laplacian pattern!");
+    return Eigen::Index(it - matrix.innerIndexPtr());
+  };
+
+  halfedgeNonzeros.resize(topo.nHalfedges);
+  for (std::size_t i = 0; i < n; ++i) {
+    for (std::size_t k = topo.begin(i); k < topo.end(i); ++k) {
+      std::size_t j = topo.neighborVertices[k];
+      halfedgeNonzeros[topo.outgoingHalfedges[k]] = {
+          nonzero(i, i), nonzero(j, j), nonzero(i, j), nonzero(j, i)};
+    }
+  }
+  ++nPatternBuilds;
+}
+
+void CotanLaplacianAssembler::update(
+    const EigenVectorX1d &halfedgeCotanWeights) {
+  if (std::size_t(halfedgeCotanWeights.rows()) != halfedgeNonzeros.size())
+    mem3dg_runtime_error(
+        "Cotan Laplacian pattern is out of date with the mesh topology!");
+
+  double *values = matrix.valuePtr();
+  std::fill(values, values + matrix.nonZeros(), 0.0);
+  for (std::size_t he = 0; he < halfedgeNonzeros.size(); ++he) {
+    double weight = halfedgeCotanWeights[he];
+    const std::array<Eigen::Index, 4> &nz = halfedgeNonzeros[he];
+    values[nz[0]] += weight;
+    values[nz[1]] += weight;
+    values[nz[2]] -= weight;
+    values[nz[3]] -= weight;
+  }
+}
+
+} // namespace solver
+} // namespace mem3dg
@@ -11,7 +11,10 @@
 //     Ravi Ramamoorthi (ravir@cs.ucsd.edu)
 //     Padmini Rangamani (prangamani@eng.ucsd.edu)
 //
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <vector>
 
 #include <geometrycentral/surface/halfedge_mesh.h>
 #include <geometrycentral/surface/simple_polygon_mesh.h>
@@ -35,139 +38,120 @@ namespace solver {
 namespace gc = ::geometrycentral;
 namespace gcs = ::geometrycentral::surface;
 
+// the vertexwise terms share one fused pass, of which each of these keeps its
+// own term
 void System::computeBendingEnergy() {
-
-  // no particular reason, just experiment
-  // E.BE = 0;
-  // for (gcs::Vertex v : mesh->vertices()) {
-  //   E.BE += Kb[v] *
-  //           (vpg->vertexMeanCurvature(v) / vpg->vertexDualArea(v) - H0[v]) *
-  //           (vpg->vertexMeanCurvature(v) / vpg->vertexDualArea(v) - H0[v]) *
-  //           vpg->vertexDualArea(v);
-  // }
-
-  // Eigen::Matrix<double, Eigen::Dynamic, 1> H_difference = H.raw() - H0.raw();
-  // E.BE = P.Kb * H_difference.transpose() * M * H_difference;
-
-  Eigen::Matrix<double, Eigen::Dynamic, 1> H_difference =
-      abs(vpg->vertexMeanCurvatures.raw().array() /
-              vpg->vertexDualAreas.raw().array() -
-          H0.raw().array());
-  energy.bendingEnergy =
-      (Kb.raw().array() * vpg->vertexDualAreas.raw().array() *
-       H_difference.array().square())
-          .sum();
-
-  // when considering topological changes, additional term of gauss curvature
-  // E.BE = P.Kb * H_difference.transpose() * M * H_difference + P.KG * (M *
-  // K).sum();
+  Energy e;
+  computeVertexEnergies(e);
+  energy.bendingEnergy = e.bendingEnergy;
 }
 
 void System::computeDeviatoricEnergy() {
-  energy.deviatoricEnergy =
-      (Kd.raw().array() * (vpg->vertexMeanCurvatures.raw().array().square() /
-                               vpg->vertexDualAreas.raw().array() -
-                           vpg->vertexGaussianCurvatures.raw().array()))
-          .sum();
-  // energy.deviatoricEnergy =
-  //     (Kd.raw().array() * (vpg->vertexMeanCurvatures.raw().array().square() /
-  //                          vpg->vertexDualAreas.raw().array()))
-  //         .sum();
-  // energy.deviatoricEnergy =
-  //     (Kd.raw().array() *
-  //     (-vpg->vertexGaussianCurvatures.raw().array())).sum();
+  Energy e;
+  computeVertexEnergies(e);
+  energy.deviatoricEnergy = e.deviatoricEnergy;
 }
 
 void System::computeSurfaceEnergy() {
-  // cotan laplacian normal is exact for area variation
-  double A_difference = surfaceArea - parameters.tension.At;
   energy.surfaceEnergy =
-      parameters.tension.isConstantSurfaceTension
-          ? forces.surfaceTension * surfaceArea
-          : forces.surfaceTension * A_difference / 2 +
-                parameters.tension.lambdaSG * A_difference / 2;
+      computeSurfaceEnergy(surfaceArea, forces.surfaceTension);
+}
+
+double System::computeSurfaceEnergy(double area,
+                                    double surfaceTension) const {
+  // cotan laplacian normal is exact for area variation
+  double A_difference = area - parameters.tension.At;
+  return parameters.tension.isConstantSurfaceTension
+             ? surfaceTension * area
+             : surfaceTension * A_difference / 2 +
+                   parameters.tension.lambdaSG * A_difference / 2;
 }
 
 void System::computePressureEnergy() {
+  energy.pressureEnergy = computePressureEnergy(volume, forces.osmoticPressure);
+}
+
+double System::computePressureEnergy(double volume,
+                                     double osmoticPressure) const {
   // Note: area weighted normal is exact volume variation
   if (parameters.osmotic.isPreferredVolume) {
     double V_difference = volume - parameters.osmotic.Vt;
-    energy.pressureEnergy = -forces.osmoticPressure * V_difference / 2 +
-                            parameters.osmotic.lambdaV * V_difference / 2;
+    return -osmoticPressure * V_difference / 2 +
+           parameters.osmotic.lambdaV * V_difference / 2;
   } else if (parameters.osmotic.isConstantOsmoticPressure) {
-    energy.pressureEnergy = -forces.osmoticPressure * volume;
+    return -osmoticPressure * volume;
   } else {
     double ratio = parameters.osmotic.cam * volume / parameters.osmotic.n;
-    energy.pressureEnergy = mem3dg::constants::i * mem3dg::constants::R *
-                            parameters.temperature * parameters.osmotic.n *
-                            (ratio - log(ratio) - 1);
+    return mem3dg::constants::i * mem3dg::constants::R *
+           parameters.temperature * parameters.osmotic.n *
+           (ratio - log(ratio) - 1);
   }
 }
 
-// void System::computeAdsorptionEnergy() {
-//   energy.adsorptionEnergy =
-//       parameters.adsorption.epsilon * (proteinDensity.raw().array()).sum();
-// }
-
-// void System::computeAggregationEnergy() {
-//   energy.aggregationEnergy =
-//       parameters.aggregation.chi *
-//       (proteinDensity.raw().array() * proteinDensity.raw().array()).sum();
-// }
-
 void System::computeAdsorptionEnergy() {
-  energy.adsorptionEnergy =
-      parameters.adsorption.epsilon *
-      (vpg->vertexDualAreas.raw().array() * proteinDensity.raw().array()).sum();
+  Energy e;
+  computeVertexEnergies(e);
+  energy.adsorptionEnergy = e.adsorptionEnergy;
 }
 
 void System::computeAggregationEnergy() {
-  energy.aggregationEnergy =
-      parameters.aggregation.chi *
-      (vpg->vertexDualAreas.raw().array() * proteinDensity.raw().array() *
-       proteinDensity.raw().array())
-          .sum();
+  Energy e;
+  computeVertexEnergies(e);
+  energy.aggregationEnergy = e.aggregationEnergy;
 }
 
 void System::computeProteinInteriorPenalty() {
-  // interior method to constrain protein density to remain from 0 to 1
-  energy.proteinInteriorPenalty =
-      -parameters.proteinDistribution.lambdaPhi *
-      ((proteinDensity.raw().array()).log().sum() +
-       (1 - proteinDensity.raw().array()).log().sum());
+  Energy e;
+  computeVertexEnergies(e);
+  energy.proteinInteriorPenalty = e.proteinInteriorPenalty;
 }
 
 void System::computeSelfAvoidanceEnergy() {
   const double d0 = parameters.selfAvoidance.d;
   const double mu = parameters.selfAvoidance.mu;
-  const double n = parameters.selfAvoidance.n;
+  const std::size_t n = parameters.selfAvoidance.n;
   double e = 0.0;
   projectedCollideTime = std::numeric_limits<double>::max();
-  for (std::size_t i = 0; i < mesh->nVertices(); ++i) {
-    gc::Vertex vi{mesh->vertex(i)};
-    gc::VertexData<bool> neighborList(*mesh, false);
-    meshProcessor.meshMutator.markVertices(neighborList, vi, n);
-    for (std::size_t j = i + 1; j < mesh->nVertices(); ++j) {
-      if (neighborList[j])
-        continue;
-      gc::Vertex vj{mesh->vertex(j)};
-
-      // double penalty = mu * vpg->vertexDualAreas[vi] * proteinDensity[vi] *
-      //                  vpg->vertexDualAreas[vj] * proteinDensity[vj];
-      double penalty = mu * proteinDensity[vi] * proteinDensity[vj];
-      // double penalty = mu;
-      // double penalty = mu * vpg->vertexDualAreas[vi] *
-      // vpg->vertexDualAreas[vj];
-
-      gc::Vector3 r =
-          vpg->inputVertexPositions[vj] - vpg->inputVertexPositions[vi];
-      double distance = gc::norm(r) - d0;
-      double collideTime = distance / gc::dot(velocity[vi] - velocity[vj], r);
-      if (collideTime < projectedCollideTime &&
-          gc::dot(velocity[vi] - velocity[vj], r) > 0)
-        projectedCollideTime = collideTime;
-      // e -= penalty * log(distance);
-      e += penalty / distance;
+  auto addPairEnergy = [&](std::size_t i, std::size_t j) {
+    // double penalty = mu * vpg->vertexDualAreas[i] * proteinDensity[i] *
+    //                  vpg->vertexDualAreas[j] * proteinDensity[j];
+    double penalty = mu * proteinDensity[i] * proteinDensity[j];
+    // double penalty = mu;
+    // double penalty = mu * vpg->vertexDualAreas[i] *
+    // vpg->vertexDualAreas[j];
+
+    gc::Vector3 r = vpg->inputVertexPositions[j] - vpg->inputVertexPositions[i];
+    double distance = gc::norm(r) - d0;
+    double collideTime = distance / gc::dot(velocity[i] - velocity[j], r);
+    if (collideTime < projectedCollideTime &&
+        gc::dot(velocity[i] - velocity[j], r) > 0)
+      projectedCollideTime = collideTime;
+    // e -= penalty * log(distance);
+    e += penalty / distance;
+  };
+
+  if (parameters.selfAvoidance.r > 0) {
+    // pairs within cutoff from the neighbor list
+    requireSelfAvoidanceNeighbors();
+    const double cutoff2 = (d0 + parameters.selfAvoidance.r) *
+                           (d0 + parameters.selfAvoidance.r);
+    auto positions = toMatrix(vpg->inputVertexPositions);
+    for (std::size_t i = 0; i < mesh->nVertices(); ++i) {
+      for (std::size_t k = selfAvoidanceNeighborOffsets[i];
+           k < selfAvoidanceNeighborOffsets[i + 1]; ++k) {
+        std::size_t j = selfAvoidanceNeighbors[k];
+        if ((positions.row(j) - positions.row(i)).squaredNorm() < cutoff2)
+          addPairEnergy(i, j);
+      }
+    }
+  } else {
+    topologyCache.requireRings(n);
+    for (std::size_t i = 0; i < mesh->nVertices(); ++i) {
+      for (std::size_t j = i + 1; j < mesh->nVertices(); ++j) {
+        if (topologyCache.isInRing(i, j))
+          continue;
+        addPairEnergy(i, j);
+      }
     }
   }
   if (projectedCollideTime == std::numeric_limits<double>::max())
@@ -176,76 +160,278 @@ void System::computeSelfAvoidanceEnergy() {
 }
 
 void System::computeDirichletEnergy() {
-  if (false) {
-    mem3dg_runtime_error("computeDirichletEnergy: out of date implementation, "
-                         "shouldn't be called!");
-    // scale the dH0 such that it is integrated over the edge
-    // this is under the case where the resolution is low, WIP
-    // auto dH0 = vpg->edgeLengths.raw().array() *  ((vpg->d0 *
-    // H0.raw()).cwiseAbs()).array(); auto dH0 = (vpg->d0 *
-    // H0.raw()).cwiseAbs();
-    // E.dE = (vpg->hodge1Inverse * F.lineTension.raw()).sum();
+  energy.dirichletEnergy = computeDirichletEnergy(proteinDensityGradient.raw(),
+                                                  vpg->faceAreas.raw());
+}
+
+void System::computeVertexEnergies(Energy &e) const {
+  computeVertexEnergies(vpg->vertexMeanCurvatures.raw(),
+                        vpg->vertexGaussianCurvatures.raw(),
+                        vpg->vertexDualAreas.raw(), proteinDensity.raw(),
+                        H0.raw(), Kb.raw(), Kd.raw(), e);
+}
+
+void System::computeVertexEnergies(
+    const EigenVectorX1d &H, const EigenVectorX1d &K, const EigenVectorX1d &A,
+    const EigenVectorX1d &phi, const EigenVectorX1d &H0_,
+    const EigenVectorX1d &Kb_, const EigenVectorX1d &Kd_, Energy &e) const {
+  const bool isDeviatoric =
+      parameters.bending.Kd != 0 || parameters.bending.Kdc != 0;
+  const bool isInteriorPenalty =
+      parameters.variation.isProteinVariation &&
+      parameters.proteinDistribution.lambdaPhi != 0;
+  const std::ptrdiff_t nVertices = A.rows();
+  const double *H_ = H.data();
+  const double *K_ = isDeviatoric ? K.data() : nullptr;
+  const double *A_ = A.data();
+  const double *phi_ = phi.data();
+  const double *H0__ = H0_.data();
+  const double *Kb__ = Kb_.data();
+  const double *Kd__ = Kd_.data();
+  double bendingEnergy = 0, deviatoricEnergy = 0, adsorption = 0,
+         aggregation = 0, interiorPenalty = 0;
+#ifdef MEM3DG_WITH_OPENMP
+#pragma omp simd reduction(+ : bendingEnergy, deviatoricEnergy, adsorption,   \
+                           aggregation, interiorPenalty)
+#endif
+  for (std::ptrdiff_t i = 0; i < nVertices; ++i) {
+    double H_difference = H_[i] / A_[i] - H0__[i];
+    bendingEnergy += Kb__[i] * A_[i] * H_difference * H_difference;
+    if (isDeviatoric)
+      deviatoricEnergy += Kd__[i] * (H_[i] * H_[i] / A_[i] - K_[i]);
+    adsorption += A_[i] * phi_[i];
+    aggregation += A_[i] * phi_[i] * phi_[i];
+    if (isInteriorPenalty)
+      interiorPenalty += std::log(phi_[i]) + std::log(1 - phi_[i]);
   }
+  e.bendingEnergy = bendingEnergy;
+  e.deviatoricEnergy = deviatoricEnergy;
+  e.adsorptionEnergy = parameters.adsorption.epsilon * adsorption;
+  e.aggregationEnergy = parameters.aggregation.chi * aggregation;
+  e.proteinInteriorPenalty =
+      isInteriorPenalty
+          ? -parameters.proteinDistribution.lambdaPhi * interiorPenalty
+          : 0;
+}
 
-  // explicit dirichlet energy
-  energy.dirichletEnergy = 0;
-  for (gcs::Face f : mesh->faces()) {
-    energy.dirichletEnergy += 0.5 * parameters.dirichlet.eta *
-                              proteinDensityGradient[f].norm2() *
-                              vpg->faceAreas[f];
+double System::computeDirichletEnergy(
+    const Eigen::Matrix<gc::Vector3, Eigen::Dynamic, 1> &gradient,
+    const EigenVectorX1d &faceAreas) const {
+  const std::ptrdiff_t nFaces = faceAreas.rows();
+  const gc::Vector3 *gradient_ = gradient.data();
+  const double *faceAreas_ = faceAreas.data();
+  double dirichletEnergy = 0;
+#ifdef MEM3DG_WITH_OPENMP
+#pragma omp simd reduction(+ : dirichletEnergy)
+#endif
+  for (std::ptrdiff_t f = 0; f < nFaces; ++f) {
+    dirichletEnergy += gradient_[f].norm2() * faceAreas_[f];
   }
+  return 0.5 * parameters.dirichlet.eta * dirichletEnergy;
+}
 
-  // alternative dirichlet energy after integration by part
-  // E.dE = 0.5 * P.eta * proteinDensity.raw().transpose() *
-  // vpg->cotanLaplacian
-  // *
-  //        proteinDensity.raw();
+double System::sumPotentialEnergy(const Energy &e) {
+  return e.bendingEnergy + e.deviatoricEnergy + e.surfaceEnergy +
+         e.pressureEnergy + e.adsorptionEnergy + e.dirichletEnergy +
+         e.aggregationEnergy + e.selfAvoidancePenalty +
+         e.proteinInteriorPenalty;
 }
 
 double System::computePotentialEnergy() {
+  Profiler::ScopedTimer timer(profiler, Profiler::ComputePotentialEnergy);
+  profiler.count(Profiler::EnergyEvaluations);
   // fundamental internal potential energy
-  energy.bendingEnergy = 0;
-  energy.deviatoricEnergy = 0;
-  energy.surfaceEnergy = 0;
-  energy.pressureEnergy = 0;
-  energy.adsorptionEnergy = 0;
-  energy.aggregationEnergy = 0;
   energy.dirichletEnergy = 0;
   energy.selfAvoidancePenalty = 0;
-  energy.proteinInteriorPenalty = 0;
 
-  computeBendingEnergy();
   computeSurfaceEnergy();
   computePressureEnergy();
 
-  // optional internal potential energy
-  computeDeviatoricEnergy();
-  if (parameters.adsorption.epsilon != 0) {
-    computeAdsorptionEnergy();
-  }
-  if (parameters.aggregation.chi != 0) {
-    computeAggregationEnergy();
-  }
+  // fused pass over vertices for all vertexwise energies
+  computeVertexEnergies(energy);
+
   if (parameters.dirichlet.eta != 0) {
     computeDirichletEnergy();
   }
+
   if (parameters.selfAvoidance.mu != 0) {
     computeSelfAvoidanceEnergy();
   }
-  if (parameters.variation.isProteinVariation &&
-      parameters.proteinDistribution.lambdaPhi != 0) {
-    computeProteinInteriorPenalty();
-  }
 
   // summerize internal potential energy
-  energy.potentialEnergy =
-      energy.bendingEnergy + energy.deviatoricEnergy + energy.surfaceEnergy +
-      energy.pressureEnergy + energy.adsorptionEnergy + energy.dirichletEnergy +
-      energy.aggregationEnergy + energy.selfAvoidancePenalty +
-      energy.proteinInteriorPenalty;
+  energy.potentialEnergy = sumPotentialEnergy(energy);
   return energy.potentialEnergy;
 }
 
+double System::evaluatePotentialEnergy(const EigenVectorX3dr &positions,
+                                       const EigenVectorX1d &protein) {
+  Profiler::ScopedTimer timer(profiler, Profiler::EvaluatePotentialEnergy);
+  profiler.count(Profiler::EnergyEvaluations);
+  const MeshTopologyCache &topology = topologyCache;
+  const std::size_t nVertices = topology.nVertices;
+  const std::size_t nFaces = topology.nFaces;
+  auto position = [&positions](std::size_t i) {
+    return gc::Vector3{positions(i, 0), positions(i, 1), positions(i, 2)};
+  };
+  auto cornerAngle = [](const gc::Vector3 &u, const gc::Vector3 &v) {
+    return std::acos(
+        std::min(std::max(gc::dot(gc::unit(u), gc::unit(v)), -1.0), 1.0));
+  };
+
+  // protein density dependent moduli of the trial
+  EigenVectorX1d H0_, Kb_, Kd_;
+  computeProteinDependentModuli(protein, H0_, Kb_, Kd_);
+  const bool isDeviatoric = (Kd_.array() != 0).any();
+
+  // single pass over faces for the trial geometry, the same quantities the
+  // full update reads from vpg: normal, area, dual area, angle sum and
+  // protein density gradient
+  std::vector<gc::Vector3> faceNormals(nFaces);
+  EigenVectorX1d faceAreas(nFaces);
+  Eigen::Matrix<gc::Vector3, Eigen::Dynamic, 1> gradients;
+  if (parameters.dirichlet.eta != 0)
+    gradients.resize(nFaces);
+  EigenVectorX1d dualAreas = EigenVectorX1d::Zero(nVertices);
+  EigenVectorX1d angleSums = EigenVectorX1d::Zero(nVertices);
+  for (std::size_t f = 0; f < nFaces; ++f) {
+    std::size_t i0 = topology.faceVertices[3 * f],
+                i1 = topology.faceVertices[3 * f + 1],
+                i2 = topology.faceVertices[3 * f + 2];
+    gc::Vector3 p0 = position(i0), p1 = position(i1), p2 = position(i2);
+    gc::Vector3 areaNormal = gc::cross(p1 - p0, p2 - p0);
+    double faceArea = 0.5 * gc::norm(areaNormal);
+    gc::Vector3 normal = gc::unit(areaNormal);
+    faceNormals[f] = normal;
+    faceAreas[f] = faceArea;
+    dualAreas[i0] += faceArea / 3;
+    dualAreas[i1] += faceArea / 3;
+    dualAreas[i2] += faceArea / 3;
+    if (isDeviatoric) {
+      angleSums[i0] += cornerAngle(p1 - p0, p2 - p0);
+      angleSums[i1] += cornerAngle(p2 - p1, p0 - p1);
+      angleSums[i2] += cornerAngle(p0 - p2, p1 - p2);
+    }
+    if (parameters.dirichlet.eta != 0) {
+      gradients[f] = computeFaceGradient(normal, faceArea, p0, p1, p2,
+                                         protein[i0], protein[i1],
+                                         protein[i2]);
+    }
+  }
+
+  // single pass over interior edges: integrated mean curvature
+  EigenVectorX1d meanCurvatures = EigenVectorX1d::Zero(nVertices);
+  for (std::size_t he = 0; he < topology.nHalfedges; ++he) {
+    std::size_t twin = topology.halfedgeTwin[he];
+    std::size_t f1 = topology.halfedgeFace[he],
+                f2 = topology.halfedgeFace[twin];
+    if (twin < he || f1 == nFaces || f2 == nFaces)
+      continue;
+    std::size_t i = topology.halfedgeVertex[he],
+                j = topology.halfedgeVertex[twin];
+    gc::Vector3 edgeVector = position(j) - position(i);
+    double edgeLength = gc::norm(edgeVector);
+    double dihedralAngle = std::atan2(
+        gc::dot(edgeVector / edgeLength,
+                gc::cross(faceNormals[f1], faceNormals[f2])),
+        gc::dot(faceNormals[f1], faceNormals[f2]));
+    meanCurvatures[i] += 0.25 * dihedralAngle * edgeLength;
+    meanCurvatures[j] += 0.25 * dihedralAngle * edgeLength;
+  }
+
+  // integrated Gaussian curvature from the angle defect
+  EigenVectorX1d gaussianCurvatures = EigenVectorX1d::Zero(nVertices);
+  if (isDeviatoric) {
+    for (std::size_t i = 0; i < nVertices; ++i) {
+      gaussianCurvatures[i] =
+          (topology.isBoundaryVertex[i] ? 1 : 2) * constants::PI -
+          angleSums[i];
+    }
+  }
+
+  // the energy terms shared with computePotentialEnergy
+  Energy trial;
+  computeVertexEnergies(meanCurvatures, gaussianCurvatures, dualAreas, protein,
+                        H0_, Kb_, Kd_, trial);
+  double area = faceAreas.sum() + parameters.tension.A_res;
+  trial.surfaceEnergy = computeSurfaceEnergy(area, computeSurfaceTension(area));
+  double volume = getMeshVolume(*mesh, positions, true) +
+                  parameters.osmotic.V_res;
+  trial.pressureEnergy =
+      computePressureEnergy(volume, computeOsmoticPressure(volume));
+  if (parameters.dirichlet.eta != 0) {
+    trial.dirichletEnergy = computeDirichletEnergy(gradients, faceAreas);
+  }
+  if (parameters.selfAvoidance.mu != 0) {
+    const double d0 = parameters.selfAvoidance.d;
+    const double mu = parameters.selfAvoidance.mu;
+    auto addPairEnergy = [&](std::size_t i, std::size_t j) {
+      double distance = (positions.row(j) - positions.row(i)).norm() - d0;
+      trial.selfAvoidancePenalty += mu * protein[i] * protein[j] / distance;
+    };
+    topologyCache.requireRings(parameters.selfAvoidance.n);
+    if (parameters.selfAvoidance.r > 0) {
+      // pairs within cutoff of the trial positions, from the reserved
+      // candidates if no vertex has moved out of their reach
+      const double cutoff = d0 + parameters.selfAvoidance.r;
+      bool isReserved =
+          trialPairReferencePositions.rows() == positions.rows() &&
+          trialPairOffsets.size() == nVertices + 1;
+      if (isReserved && nVertices > 0) {
+        double maxDisplacement =
+            std::sqrt((positions - trialPairReferencePositions)
+                          .rowwise()
+                          .squaredNorm()
+                          .maxCoeff());
+        isReserved = cutoff + 2 * maxDisplacement <= trialPairCutoff;
+      }
+      std::vector<std::size_t> offsets, neighbors;
+      if (!isReserved) {
+        CellList trialCellList;
+        trialCellList.build(positions, cutoff);
+        trialCellList.findPairs(positions, cutoff, offsets, neighbors);
+      }
+      const std::vector<std::size_t> &pairOffsets =
+          isReserved ? trialPairOffsets : offsets;
+      const std::vector<std::size_t> &pairNeighbors =
+          isReserved ? trialPairNeighbors : neighbors;
+      const double cutoff2 = cutoff * cutoff;
+      for (std::size_t i = 0; i < nVertices; ++i) {
+        for (std::size_t k = pairOffsets[i]; k < pairOffsets[i + 1]; ++k) {
+          std::size_t j = pairNeighbors[k];
+          if ((positions.row(j) - positions.row(i)).squaredNorm() < cutoff2 &&
+              !topology.isInRing(i, j))
+            addPairEnergy(i, j);
+        }
+      }
+    } else {
+      for (std::size_t i = 0; i < nVertices; ++i) {
+        for (std::size_t j = i + 1; j < nVertices; ++j) {
+          if (!topology.isInRing(i, j))
+            addPairEnergy(i, j);
+        }
+      }
+    }
+  }
+  return sumPotentialEnergy(trial);
+}
+
+void System::reserveTrialPairs(const EigenVectorX3dr &positions,
+                               double maxDisplacement) {
+  trialPairOffsets.clear();
+  trialPairNeighbors.clear();
+  trialPairReferencePositions.resize(0, 3);
+  if (parameters.selfAvoidance.mu == 0 || parameters.selfAvoidance.r <= 0 ||
+      !std::isfinite(maxDisplacement))
+    return;
+  trialPairCutoff = parameters.selfAvoidance.d + parameters.selfAvoidance.r +
+                    2 * maxDisplacement;
+  CellList trialCellList;
+  trialCellList.build(positions, trialPairCutoff);
+  trialCellList.findPairs(positions, trialPairCutoff, trialPairOffsets,
+                          trialPairNeighbors);
+  trialPairReferencePositions = positions;
+}
+
 double System::computeIntegratedPower(double dt) {
   prescribeExternalForce();
   return dt * rowwiseDotProduct(toMatrix(forces.externalForceVec),
@@ -294,16 +480,28 @@ void System::computeGradient(gcs::VertexData<double> &quantities,
     gradient.fill({0, 0, 0});
   } else {
     for (gcs::Face f : mesh->faces()) {
-      gc::Vector3 normal = vpg->faceNormals[f];
-      gc::Vector3 gradientVec{0, 0, 0};
-      for (gcs::Halfedge he : f.adjacentHalfedges()) {
-        gradientVec += quantities[he.next().tipVertex()] *
-                       gc::cross(normal, vecFromHalfedge(he, *vpg));
-      }
-      gradient[f] = gradientVec / 2 / vpg->faceAreas[f];
+      gcs::Halfedge he = f.halfedge();
+      gcs::Vertex v0 = he.tailVertex(), v1 = he.tipVertex(),
+                  v2 = he.next().tipVertex();
+      gradient[f] = computeFaceGradient(
+          vpg->faceNormals[f], vpg->faceAreas[f], vpg->inputVertexPositions[v0],
+          vpg->inputVertexPositions[v1], vpg->inputVertexPositions[v2],
+          quantities[v0], quantities[v1], quantities[v2]);
     }
   }
 }
 
+gc::Vector3 System::computeFaceGradient(const gc::Vector3 &normal,
+                                        double faceArea, const gc::Vector3 &p0,
+                                        const gc::Vector3 &p1,
+                                        const gc::Vector3 &p2, double q0,
+                                        double q1, double q2) {
+  // quantity at the vertex opposite to each edge times the rotated edge
+  gc::Vector3 gradient = q2 * gc::cross(normal, p1 - p0) +
+                         q0 * gc::cross(normal, p2 - p1) +
+                         q1 * gc::cross(normal, p0 - p2);
+  return gradient / 2 / faceArea;
+}
+
 } // namespace solver
 } // namespace mem3dg
@@ -14,9 +14,12 @@
 
 // uncomment to disable assert()
 // #define NDEBUG
+#include <algorithm>
+#include <array>
 #include <cassert>
 #include <cmath>
 #include <iostream>
+#include <utility>
 
 #include <geometrycentral/numerical/linear_solvers.h>
 #include <geometrycentral/surface/halfedge_mesh.h>
@@ -238,14 +241,59 @@ gcs::VertexData<gc::Vector3> System::halfedgeVectorToVertexVector(
   return vector;
 }
 
+void System::computeHalfedgeVariationalVectors() {
+  assert(mesh->isCompressed());
+  // every edge contributes its dihedral angle gradient wrt its 4 vertices,
+  // computed once here instead of from every neighboring vertex
+  const std::ptrdiff_t nHalfedges = mesh->nHalfedges();
+#ifdef MEM3DG_WITH_OPENMP
+  const int nThreads_ = static_cast<int>(std::max<std::size_t>(nThreads, 1));
+#pragma omp parallel for num_threads(nThreads_) schedule(static)               \
+    if (nThreads_ > 1)
+#endif
+  for (std::ptrdiff_t i = 0; i < nHalfedges; ++i) {
+    gc::Halfedge he{mesh->halfedge(static_cast<std::size_t>(i))};
+    double l = vpg->edgeLengths[he.edge()];
+    halfedgeAreaGradient[he] = 2 * computeHalfedgeMeanCurvatureVector(*vpg, he);
+    halfedgeGaussianCurvatureVector[he] =
+        computeHalfedgeGaussianCurvatureVector(*vpg, he);
+    halfedgeVolumeVariationVector[he] =
+        computeHalfedgeVolumeVariationVector(*vpg, he);
+    halfedgeSchlafliTailVector[he] = l * dihedralAngleGradient(he, he.vertex());
+    halfedgeSchlafliOppositeVector[he] =
+        l * dihedralAngleGradient(he, he.next().next().vertex());
+  }
+}
+
 void System::computeMechanicalForces() {
+  Profiler::ScopedTimer timer(profiler, Profiler::ComputeMechanicalForces);
   assert(mesh->isCompressed());
   // if(!mesh->isCompressed()){
   //   mem3dg_runtime_error("Mesh must be compressed to compute forces!");
   // }
-
-  for (std::size_t i = 0; i < mesh->nVertices(); ++i) {
-    computeMechanicalForces(i);
+  assert(topologyCache.isConsistent(*mesh));
+
+  // the diagnostics of a previous configuration are not carried along
+  if (forces.isDiagnostic)
+    forces.hasDiagnostics = true;
+  else
+    forces.clearDiagnostics();
+
+  computeHalfedgeVariationalVectors();
+  const MechanicalForceKernel kernel =
+      mechanicalForceKernels[getMechanicalForceTerms()];
+
+  // each vertex only reads the shared geometry and writes to its own slot in
+  // forces, hence the result is identical regardless of the thread count.
+  // Without OpenMP, nThreads is ignored and the loop runs serially
+  const std::ptrdiff_t nVertices = mesh->nVertices();
+#ifdef MEM3DG_WITH_OPENMP
+  const int nThreads_ = static_cast<int>(std::max<std::size_t>(nThreads, 1));
+#pragma omp parallel for num_threads(nThreads_) schedule(static)               \
+    if (nThreads_ > 1)
+#endif
+  for (std::ptrdiff_t i = 0; i < nVertices; ++i) {
+    (this->*kernel)(static_cast<std::size_t>(i));
   }
 
   // measure smoothness
@@ -260,8 +308,31 @@ void System::computeMechanicalForces(gcs::Vertex &v) {
   computeMechanicalForces(i);
 }
 
+unsigned System::getMechanicalForceTerms() const {
+  unsigned terms = 0;
+  if (parameters.bending.Kd != 0 || parameters.bending.Kdc != 0)
+    terms |= DeviatoricTerm;
+  if (parameters.adsorption.epsilon != 0)
+    terms |= AdsorptionTerm;
+  if (parameters.aggregation.chi != 0)
+    terms |= AggregationTerm;
+  if (parameters.dirichlet.eta != 0)
+    terms |= LineCapillaryTerm;
+  return terms;
+}
+
 void System::computeMechanicalForces(size_t i) {
-  gc::Vertex v{mesh->vertex(i)};
+  (this->*mechanicalForceKernels[getMechanicalForceTerms()])(i);
+}
+
+template <unsigned Terms>
+void System::computeMechanicalForcesKernel(size_t i) {
+  // the disabled terms are compile time constants and compile away
+  constexpr bool isDeviatoric = Terms & DeviatoricTerm;
+  constexpr bool isAdsorption = Terms & AdsorptionTerm;
+  constexpr bool isAggregation = Terms & AggregationTerm;
+  constexpr bool isLineCapillary = Terms & LineCapillaryTerm;
+
   gc::Vector3 bendingForceVec{0, 0, 0};
   gc::Vector3 bendingForceVec_areaGrad{0, 0, 0};
   gc::Vector3 bendingForceVec_gaussVec{0, 0, 0};
@@ -281,61 +352,68 @@ void System::computeMechanicalForces(size_t i) {
   double Kbi = Kb[i];
   double Kdi = Kd[i];
   double proteinDensityi = proteinDensity[i];
-  bool boundaryVertex = v.isBoundary();
+  bool boundaryVertex = topologyCache.isBoundaryVertex[i];
 
-  for (gc::Halfedge he : v.outgoingHalfedges()) {
-    std::size_t fID = he.face().getIndex();
+  // traverse the one-ring through the flat connectivity snapshot
+  const MeshTopologyCache &topo = topologyCache;
+  for (std::size_t k = topo.begin(i); k < topo.end(i); ++k) {
+    std::size_t heID = topo.outgoingHalfedges[k];
+    gc::Halfedge he{mesh->halfedge(heID)};
+    std::size_t fID = topo.faces[k];
 
     // Initialize local variables for computation
-    std::size_t i_vj = he.tipVertex().getIndex();
+    std::size_t i_vj = topo.neighborVertices[k];
 
-    gc::Vector3 dphi_ijk{he.isInterior() ? proteinDensityGradient[fID]
-                                         : gc::Vector3{0, 0, 0}};
+    bool interiorHalfedge = topo.isInteriorHalfedge[k];
+    bool boundaryEdge = topo.isBoundaryEdge[k];
+    bool boundaryNeighborVertex = topo.isBoundaryVertex[i_vj];
     double Hj = vpg->vertexMeanCurvatures[i_vj] / vpg->vertexDualAreas[i_vj];
     double H0j = H0[i_vj];
     double Kbj = Kb[i_vj];
     double Kdj = Kd[i_vj];
     double proteinDensityj = proteinDensity[i_vj];
-    bool interiorHalfedge = he.isInterior();
-    bool boundaryEdge = he.edge().isBoundary();
-    bool boundaryNeighborVertex = he.next().vertex().isBoundary();
-
-    gc::Vector3 areaGrad = 2 * computeHalfedgeMeanCurvatureVector(*vpg, he);
-    gc::Vector3 gaussVec = computeHalfedgeGaussianCurvatureVector(*vpg, he);
-    gc::Vector3 schlafliVec1;
-    gc::Vector3 schlafliVec2;
-    // std::tie(schlafliVec1, schlafliVec2) =
-    //     computeHalfedgeSchlafliVector(*vpg, he);
-    schlafliVec1 =
-        vpg->edgeLengths[he.edge()] * dihedralAngleGradient(he, he.vertex());
-    schlafliVec2 =
-        vpg->edgeLengths[he.twin().edge()] *
-            dihedralAngleGradient(he.twin(), he.vertex()) +
-        vpg->edgeLengths[he.next().edge()] *
-            dihedralAngleGradient(he.next(), he.vertex()) +
-        vpg->edgeLengths[he.twin().next().next().edge()] *
-            dihedralAngleGradient(he.twin().next().next(), he.vertex());
-    gc::Vector3 oneSidedAreaGrad{0, 0, 0};
-    gc::Vector3 dirichletVec{0, 0, 0};
-    if (interiorHalfedge) {
-      oneSidedAreaGrad = 0.5 * gc::cross(vpg->faceNormals[fID],
-                                         vecFromHalfedge(he.next(), *vpg));
-      dirichletVec = computeGradientNorm2Gradient(he, proteinDensity) /
-                     vpg->faceAreas[fID];
-    }
+
+    // gather from cached halfedge variational vectors
+    gc::Vector3 areaGrad = halfedgeAreaGradient[heID];
+    gc::Vector3 gaussVec = halfedgeGaussianCurvatureVector[heID];
+    // the dihedral angle gradient of he.edge() wrt he.vertex() is the same
+    // from either he or its twin
+    std::size_t heID_next = topo.halfedgeNext[heID];
+    std::size_t heID_twin_prev =
+        topo.halfedgeNext[topo.halfedgeNext[topo.halfedgeTwin[heID]]];
+    gc::Vector3 schlafliVec1 = halfedgeSchlafliTailVector[heID];
+    gc::Vector3 schlafliVec2 = halfedgeSchlafliTailVector[heID] +
+                               halfedgeSchlafliOppositeVector[heID_next] +
+                               halfedgeSchlafliOppositeVector[heID_twin_prev];
 
     // Assemble to forces
     osmoticForceVec +=
-        forces.osmoticPressure * computeHalfedgeVolumeVariationVector(*vpg, he);
+        forces.osmoticPressure * halfedgeVolumeVariationVector[heID];
     capillaryForceVec -= forces.surfaceTension * areaGrad;
-    adsorptionForceVec -= (proteinDensityi / 3 + proteinDensityj * 2 / 3) *
-                          parameters.adsorption.epsilon * areaGrad;
-    aggregationForceVec -= (proteinDensityi * proteinDensityi / 3 +
-                            proteinDensityj * proteinDensityj * 2 / 3) *
-                           parameters.aggregation.chi * areaGrad;
-    lineCapForceVec -=
-        parameters.dirichlet.eta *
-        (0.125 * dirichletVec - 0.5 * dphi_ijk.norm2() * oneSidedAreaGrad);
+    if (isAdsorption) {
+      adsorptionForceVec -= (proteinDensityi / 3 + proteinDensityj * 2 / 3) *
+                            parameters.adsorption.epsilon * areaGrad;
+    }
+    if (isAggregation) {
+      aggregationForceVec -= (proteinDensityi * proteinDensityi / 3 +
+                              proteinDensityj * proteinDensityj * 2 / 3) *
+                             parameters.aggregation.chi * areaGrad;
+    }
+    if (isLineCapillary) {
+      gc::Vector3 dphi_ijk{interiorHalfedge ? proteinDensityGradient[fID]
+                                            : gc::Vector3{0, 0, 0}};
+      gc::Vector3 oneSidedAreaGrad{0, 0, 0};
+      gc::Vector3 dirichletVec{0, 0, 0};
+      if (interiorHalfedge) {
+        oneSidedAreaGrad = 0.5 * gc::cross(vpg->faceNormals[fID],
+                                           vecFromHalfedge(he.next(), *vpg));
+        dirichletVec = computeGradientNorm2Gradient(he, proteinDensity) /
+                       vpg->faceAreas[fID];
+      }
+      lineCapForceVec -=
+          parameters.dirichlet.eta *
+          (0.125 * dirichletVec - 0.5 * dphi_ijk.norm2() * oneSidedAreaGrad);
+    }
 
     bendingForceVec_schlafliVec -=
         (Kbi * (Hi - H0i) * schlafliVec1 + Kbj * (Hj - H0j) * schlafliVec2);
@@ -345,6 +423,8 @@ void System::computeMechanicalForces(size_t i) {
     bendingForceVec_gaussVec -=
         (Kbi * (Hi - H0i) + Kbj * (Hj - H0j)) * gaussVec;
 
+    if (!isDeviatoric)
+      continue;
     deviatoricForceVec_mean -=
         (Kdi * Hi + Kdj * Hj) * gaussVec +
         (Kdi * (-Hi * Hi) / 3 + Kdj * (-Hj * Hj) * 2 / 3) * areaGrad +
@@ -387,49 +467,77 @@ void System::computeMechanicalForces(size_t i) {
   // deviatoricForceVec = deviatoricForceVec_mean;
 
   // masking
-  bendingForceVec_areaGrad = forces.maskForce(bendingForceVec_areaGrad, i);
-  bendingForceVec_gaussVec = forces.maskForce(bendingForceVec_gaussVec, i);
-  bendingForceVec_schlafliVec =
-      forces.maskForce(bendingForceVec_schlafliVec, i);
   bendingForceVec = forces.maskForce(bendingForceVec, i);
-
-  deviatoricForceVec_mean = forces.maskForce(deviatoricForceVec_mean, i);
-  deviatoricForceVec_gauss = forces.maskForce(deviatoricForceVec_gauss, i);
-  deviatoricForceVec = forces.maskForce(deviatoricForceVec, i);
+  if (isDeviatoric)
+    deviatoricForceVec = forces.maskForce(deviatoricForceVec, i);
 
   osmoticForceVec = forces.maskForce(osmoticForceVec, i);
   capillaryForceVec = forces.maskForce(capillaryForceVec, i);
-  lineCapForceVec = forces.maskForce(lineCapForceVec, i);
-  adsorptionForceVec = forces.maskForce(adsorptionForceVec, i);
-  aggregationForceVec = forces.maskForce(aggregationForceVec, i);
+  if (isLineCapillary)
+    lineCapForceVec = forces.maskForce(lineCapForceVec, i);
+  if (isAdsorption)
+    adsorptionForceVec = forces.maskForce(adsorptionForceVec, i);
+  if (isAggregation)
+    aggregationForceVec = forces.maskForce(aggregationForceVec, i);
 
   // Combine to one
-  forces.bendingForceVec_areaGrad[i] = bendingForceVec_areaGrad;
-  forces.bendingForceVec_gaussVec[i] = bendingForceVec_gaussVec;
-  forces.bendingForceVec_schlafliVec[i] = bendingForceVec_schlafliVec;
   forces.bendingForceVec[i] = bendingForceVec;
-
   forces.deviatoricForceVec[i] = deviatoricForceVec;
-  forces.deviatoricForceVec_mean[i] = deviatoricForceVec_mean;
-  forces.deviatoricForceVec_gauss[i] = deviatoricForceVec_gauss;
-
   forces.capillaryForceVec[i] = capillaryForceVec;
   forces.osmoticForceVec[i] = osmoticForceVec;
   forces.lineCapillaryForceVec[i] = lineCapForceVec;
   forces.adsorptionForceVec[i] = adsorptionForceVec;
   forces.aggregationForceVec[i] = aggregationForceVec;
 
-  // Scalar force by projection to angle-weighted normal
+  // diagnostic decompositions and scalar projections are only for output
+  if (!forces.isDiagnostic)
+    return;
+
+  forces.bendingForceVec_areaGrad[i] =
+      forces.maskForce(bendingForceVec_areaGrad, i);
+  forces.bendingForceVec_gaussVec[i] =
+      forces.maskForce(bendingForceVec_gaussVec, i);
+  forces.bendingForceVec_schlafliVec[i] =
+      forces.maskForce(bendingForceVec_schlafliVec, i);
+  forces.deviatoricForceVec_mean[i] =
+      isDeviatoric ? forces.maskForce(deviatoricForceVec_mean, i)
+                   : gc::Vector3{0, 0, 0};
+  forces.deviatoricForceVec_gauss[i] =
+      isDeviatoric ? forces.maskForce(deviatoricForceVec_gauss, i)
+                   : gc::Vector3{0, 0, 0};
+
+  // Scalar force by projection to angle-weighted normal, zero if disabled
   forces.bendingForce[i] = forces.ontoNormal(bendingForceVec, i);
-  forces.deviatoricForce[i] = forces.ontoNormal(deviatoricForceVec, i);
+  forces.deviatoricForce[i] =
+      isDeviatoric ? forces.ontoNormal(deviatoricForceVec, i) : 0;
   forces.capillaryForce[i] = forces.ontoNormal(capillaryForceVec, i);
   forces.osmoticForce[i] = forces.ontoNormal(osmoticForceVec, i);
-  forces.lineCapillaryForce[i] = forces.ontoNormal(lineCapForceVec, i);
-  forces.adsorptionForce[i] = forces.ontoNormal(adsorptionForceVec, i);
-  forces.aggregationForce[i] = forces.ontoNormal(aggregationForceVec, i);
+  forces.lineCapillaryForce[i] =
+      isLineCapillary ? forces.ontoNormal(lineCapForceVec, i) : 0;
+  forces.adsorptionForce[i] =
+      isAdsorption ? forces.ontoNormal(adsorptionForceVec, i) : 0;
+  forces.aggregationForce[i] =
+      isAggregation ? forces.ontoNormal(aggregationForceVec, i) : 0;
+}
+
+// the full kernel is available to other translation units, e.g. as reference
+template void System::computeMechanicalForcesKernel<System::AllTerms>(size_t);
+
+namespace {
+/// one instantiation of the mechanical force kernel per bitmask of terms
+template <unsigned... Terms>
+std::array<System::MechanicalForceKernel, sizeof...(Terms)>
+makeMechanicalForceKernels(std::integer_sequence<unsigned, Terms...>) {
+  return {{&System::computeMechanicalForcesKernel<Terms>...}};
 }
+} // namespace
+
+const std::array<System::MechanicalForceKernel, System::AllTerms + 1>
+    System::mechanicalForceKernels = makeMechanicalForceKernels(
+        std::make_integer_sequence<unsigned, System::AllTerms + 1>{});
 
 EigenVectorX3dr System::prescribeExternalForce() {
+  Profiler::ScopedTimer timer(profiler, Profiler::PrescribeExternalForce);
 #define MODE 1
 #if MODE == 0 // axial sinusoidal force
   double freq = 5;
@@ -464,8 +572,7 @@ EigenVectorX3dr System::prescribeExternalForce() {
 
 #elif MODE == 2 // anchor force
   double decayTime = 500;
-  gcs::HeatMethodDistanceSolver heatSolver(*vpg);
-  geodesicDistanceFromPtInd = heatSolver.computeDistance(thePoint);
+  geodesicDistanceFromPtInd = geodesicSolver.computeDistance(*vpg, thePoint);
   double standardDeviation = 0.02;
 
   // gc::Vector3 anchor{0, 0, 1};
@@ -481,48 +588,121 @@ EigenVectorX3dr System::prescribeExternalForce() {
                          i);
   }
 #endif
-  forces.externalForce = forces.ontoNormal(forces.externalForceVec);
+  if (forces.isDiagnostic)
+    forces.externalForce = forces.ontoNormal(forces.externalForceVec);
 
   return toMatrix(forces.externalForceVec);
 }
 
+void System::updateSelfAvoidanceNeighbors() {
+  const double cutoff = parameters.selfAvoidance.d +
+                        parameters.selfAvoidance.r +
+                        parameters.selfAvoidance.skin;
+  const std::size_t n = parameters.selfAvoidance.n;
+  const std::size_t nVertices = mesh->nVertices();
+  auto positions = toMatrix(vpg->inputVertexPositions);
+
+  // candidate pairs within cutoff
+  std::vector<std::size_t> offsets, neighbors;
+  cellList.build(positions, cutoff);
+  cellList.findPairs(positions, cutoff, offsets, neighbors);
+
+  // exclude the n-ring neighborhood
+  topologyCache.requireRings(n);
+  selfAvoidanceNeighborOffsets.assign(nVertices + 1, 0);
+  selfAvoidanceNeighbors.clear();
+  for (std::size_t i = 0; i < nVertices; ++i) {
+    for (std::size_t k = offsets[i]; k < offsets[i + 1]; ++k) {
+      if (!topologyCache.isInRing(i, neighbors[k]))
+        selfAvoidanceNeighbors.push_back(neighbors[k]);
+    }
+    selfAvoidanceNeighborOffsets[i + 1] = selfAvoidanceNeighbors.size();
+  }
+
+  selfAvoidanceReferencePositions = positions;
+  isSelfAvoidanceNeighborsStale = false;
+}
+
+bool System::requireSelfAvoidanceNeighbors() {
+  bool isRebuild = isSelfAvoidanceNeighborsStale ||
+                   selfAvoidanceReferencePositions.rows() !=
+                       static_cast<Eigen::Index>(mesh->nVertices()) ||
+                   cellList.cellSize != parameters.selfAvoidance.d +
+                                            parameters.selfAvoidance.r +
+                                            parameters.selfAvoidance.skin ||
+                   topologyCache.ringLayer != parameters.selfAvoidance.n;
+  if (!isRebuild) {
+    // maximum displacement since the last build
+    double maxDisplacement2 =
+        (toMatrix(vpg->inputVertexPositions) - selfAvoidanceReferencePositions)
+            .rowwise()
+            .squaredNorm()
+            .maxCoeff();
+    double halfSkin = 0.5 * parameters.selfAvoidance.skin;
+    isRebuild = maxDisplacement2 > halfSkin * halfSkin;
+  }
+  if (isRebuild)
+    updateSelfAvoidanceNeighbors();
+  return isRebuild;
+}
+
 void System::computeSelfAvoidanceForce() {
+  Profiler::ScopedTimer timer(profiler, Profiler::ComputeSelfAvoidanceForce);
   forces.selfAvoidanceForceVec.fill({0, 0, 0});
   const double d0 = parameters.selfAvoidance.d;
   const double mu = parameters.selfAvoidance.mu;
-  const double n = parameters.selfAvoidance.n;
-  for (std::size_t i = 0; i < mesh->nVertices(); ++i) {
-    gc::Vertex vi{mesh->vertex(i)};
-    gc::VertexData<bool> neighborList(*mesh, false);
-    meshProcessor.meshMutator.markVertices(neighborList, vi, n);
-    for (std::size_t j = i + 1; j < mesh->nVertices(); ++j) {
-      if (neighborList[j])
-        continue;
-      gc::Vertex vj{mesh->vertex(j)};
-      // double penalty = mu * vpg->vertexDualAreas[vi] * proteinDensity[vi] *
-      //                  vpg->vertexDualAreas[vj] * proteinDensity[vj];
-      double penalty = mu * proteinDensity[vi] * proteinDensity[vj];
-      // double penalty = mu;
-      // double penalty = mu * vpg->vertexDualAreas[vi] *
-      // vpg->vertexDualAreas[vj];;
-      gc::Vector3 r =
-          vpg->inputVertexPositions[vj] - vpg->inputVertexPositions[vi];
-      double distance = gc::norm(r) - d0;
-      gc::Vector3 grad = r.normalize();
-      // forces.selfAvoidanceForceVec[i] -=
-      //     forces.maskForce(penalty / distance * grad, i);
-      // forces.selfAvoidanceForceVec[j] +=
-      //     forces.maskForce(penalty / distance * grad, j);
-      forces.selfAvoidanceForceVec[i] -=
-          forces.maskForce(penalty / distance / distance * grad, i);
-      forces.selfAvoidanceForceVec[j] +=
-          forces.maskForce(penalty / distance / distance * grad, j);
+  const std::size_t n = parameters.selfAvoidance.n;
+  auto addPairForce = [&](std::size_t i, std::size_t j) {
+    // double penalty = mu * vpg->vertexDualAreas[i] * proteinDensity[i] *
+    //                  vpg->vertexDualAreas[j] * proteinDensity[j];
+    double penalty = mu * proteinDensity[i] * proteinDensity[j];
+    // double penalty = mu;
+    // double penalty = mu * vpg->vertexDualAreas[i] *
+    // vpg->vertexDualAreas[j];;
+    gc::Vector3 r = vpg->inputVertexPositions[j] - vpg->inputVertexPositions[i];
+    double distance = gc::norm(r) - d0;
+    gc::Vector3 grad = r.normalize();
+    // forces.selfAvoidanceForceVec[i] -=
+    //     forces.maskForce(penalty / distance * grad, i);
+    // forces.selfAvoidanceForceVec[j] +=
+    //     forces.maskForce(penalty / distance * grad, j);
+    forces.selfAvoidanceForceVec[i] -=
+        forces.maskForce(penalty / distance / distance * grad, i);
+    forces.selfAvoidanceForceVec[j] +=
+        forces.maskForce(penalty / distance / distance * grad, j);
+  };
+
+  if (parameters.selfAvoidance.r > 0) {
+    // pairs within cutoff from the neighbor list
+    requireSelfAvoidanceNeighbors();
+    const double cutoff2 = (d0 + parameters.selfAvoidance.r) *
+                           (d0 + parameters.selfAvoidance.r);
+    auto positions = toMatrix(vpg->inputVertexPositions);
+    for (std::size_t i = 0; i < mesh->nVertices(); ++i) {
+      for (std::size_t k = selfAvoidanceNeighborOffsets[i];
+           k < selfAvoidanceNeighborOffsets[i + 1]; ++k) {
+        std::size_t j = selfAvoidanceNeighbors[k];
+        if ((positions.row(j) - positions.row(i)).squaredNorm() < cutoff2)
+          addPairForce(i, j);
+      }
+    }
+  } else {
+    topologyCache.requireRings(n);
+    for (std::size_t i = 0; i < mesh->nVertices(); ++i) {
+      for (std::size_t j = i + 1; j < mesh->nVertices(); ++j) {
+        if (topologyCache.isInRing(i, j))
+          continue;
+        addPairForce(i, j);
+      }
     }
   }
-  forces.selfAvoidanceForce = forces.ontoNormal(forces.selfAvoidanceForceVec);
+  if (forces.isDiagnostic)
+    forces.selfAvoidanceForce =
+        forces.ontoNormal(forces.selfAvoidanceForceVec);
 }
 
 void System::computeChemicalPotentials() {
+  Profiler::ScopedTimer timer(profiler, Profiler::ComputeChemicalPotentials);
   gcs::VertexData<double> dH0dphi(*mesh, 0);
   gcs::VertexData<double> dKbdphi(*mesh, 0);
   gcs::VertexData<double> dKddphi(*mesh, 0);
@@ -582,9 +762,13 @@ void System::computeChemicalPotentials() {
   //   forces.aggregationPotential.raw() = forces.maskProtein(
   //       -2 * parameters.aggregation.chi * proteinDensity.raw().array());
 
-  if (parameters.dirichlet.eta != 0)
-    forces.diffusionPotential.raw() = forces.maskProtein(
-        -parameters.dirichlet.eta * vpg->cotanLaplacian * proteinDensity.raw());
+  if (parameters.dirichlet.eta != 0) {
+    cotanLaplacianAssembler.update(vpg->halfedgeCotanWeights.raw());
+    forces.diffusionPotential.raw() =
+        forces.maskProtein(-parameters.dirichlet.eta *
+                           cotanLaplacianAssembler.matrix *
+                           proteinDensity.raw());
+  }
 
   if (parameters.proteinDistribution.lambdaPhi != 0)
     forces.interiorPenaltyPotential.raw() =
@@ -602,6 +786,7 @@ void System::computeChemicalPotentials() {
 }
 
 void System::computeDPDForces(double dt) {
+  Profiler::ScopedTimer timer(profiler, Profiler::ComputeDPDForces);
   toMatrix(forces.dampingForceVec).setZero();
   toMatrix(forces.stochasticForceVec).setZero();
   // std::default_random_engine random_generator;
@@ -740,39 +925,50 @@ double System::computeNorm(
 }
 
 void System::computePhysicalForcing() {
-
-  // zero all forces
-  forces.mechanicalForceVec.fill({0, 0, 0});
-
-  forces.bendingForceVec.fill({0, 0, 0});
-  forces.bendingForceVec_areaGrad.fill({0, 0, 0});
-  forces.bendingForceVec_gaussVec.fill({0, 0, 0});
-  forces.bendingForceVec_schlafliVec.fill({0, 0, 0});
-
-  forces.deviatoricForceVec.fill({0, 0, 0});
-
-  forces.capillaryForceVec.fill({0, 0, 0});
-  forces.osmoticForceVec.fill({0, 0, 0});
-  forces.lineCapillaryForceVec.fill({0, 0, 0});
-  forces.adsorptionForceVec.fill({0, 0, 0});
-  forces.aggregationForceVec.fill({0, 0, 0});
-  forces.externalForceVec.fill({0, 0, 0});
-  forces.selfAvoidanceForceVec.fill({0, 0, 0});
+  Profiler::ScopedTimer timer(profiler, Profiler::ComputePhysicalForcing);
+
+  // zero the forces that are not overwritten below. The vertexwise force
+  // terms are overwritten by computeMechanicalForces under shape variation
+  if (!parameters.variation.isShapeVariation) {
+    forces.mechanicalForceVec.fill({0, 0, 0});
+
+    forces.bendingForceVec.fill({0, 0, 0});
+    forces.bendingForceVec_areaGrad.fill({0, 0, 0});
+    forces.bendingForceVec_gaussVec.fill({0, 0, 0});
+    forces.bendingForceVec_schlafliVec.fill({0, 0, 0});
+
+    forces.deviatoricForceVec.fill({0, 0, 0});
+    forces.deviatoricForceVec_mean.fill({0, 0, 0});
+    forces.deviatoricForceVec_gauss.fill({0, 0, 0});
+
+    forces.capillaryForceVec.fill({0, 0, 0});
+    forces.osmoticForceVec.fill({0, 0, 0});
+    forces.lineCapillaryForceVec.fill({0, 0, 0});
+    forces.adsorptionForceVec.fill({0, 0, 0});
+    forces.aggregationForceVec.fill({0, 0, 0});
+
+    forces.mechanicalForce.raw().setZero();
+    forces.bendingForce.raw().setZero();
+    forces.deviatoricForce.raw().setZero();
+    forces.capillaryForce.raw().setZero();
+    forces.lineCapillaryForce.raw().setZero();
+    forces.adsorptionForce.raw().setZero();
+    forces.aggregationForce.raw().setZero();
+    forces.osmoticForce.raw().setZero();
+  }
+  if (!parameters.variation.isShapeVariation || parameters.external.Kf == 0) {
+    forces.externalForceVec.fill({0, 0, 0});
+    forces.externalForce.raw().setZero();
+  }
+  if (!parameters.variation.isShapeVariation ||
+      parameters.selfAvoidance.mu == 0) {
+    forces.selfAvoidanceForceVec.fill({0, 0, 0});
+    forces.selfAvoidanceForce.raw().setZero();
+  }
 
   forces.dampingForceVec.fill({0, 0, 0});
   forces.stochasticForceVec.fill({0, 0, 0});
 
-  forces.mechanicalForce.raw().setZero();
-  forces.bendingForce.raw().setZero();
-  forces.deviatoricForce.raw().setZero();
-  forces.capillaryForce.raw().setZero();
-  forces.lineCapillaryForce.raw().setZero();
-  forces.externalForce.raw().setZero();
-  forces.adsorptionForce.raw().setZero();
-  forces.aggregationForce.raw().setZero();
-  forces.osmoticForce.raw().setZero();
-  forces.selfAvoidanceForce.raw().setZero();
-
   forces.chemicalPotential.raw().setZero();
 
   forces.diffusionPotential.raw().setZero();
@@ -820,6 +1016,18 @@ void System::computePhysicalForcing() {
                       : 0;
 }
 
+void System::computeForceDiagnostics() {
+  if (!parameters.variation.isShapeVariation)
+    return;
+  Forces::DiagnosticScope diagnosticScope(forces, true);
+  // the force terms are recomputed identically along with their
+  // decompositions, while the integrated force, including damping and
+  // stochastic terms, and the error norms are left untouched
+  computeMechanicalForces();
+  forces.externalForce = forces.ontoNormal(forces.externalForceVec);
+  forces.selfAvoidanceForce = forces.ontoNormal(forces.selfAvoidanceForceVec);
+}
+
 void System::computePhysicalForcing(double timeStep) {
   computePhysicalForcing();
   if (parameters.variation.isShapeVariation && parameters.dpd.gamma != 0) {
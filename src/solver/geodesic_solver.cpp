@@ -0,0 +1,52 @@
+// Membrane Dynamics in 3D using Discrete Differential Geometry (Mem3DG)
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright (c) 2020:
+//     Laboratory for Computational Cellular Mechanobiology
+//     Cuncheng Zhu (cuzhu@eng.ucsd.edu)
+//     Christopher T. Lee (ctlee@ucsd.edu)
+//     Ravi Ramamoorthi (ravir@cs.ucsd.edu)
+//     Padmini Rangamani (prangamani@eng.ucsd.edu)
+//
+
+
+#include "mem3dg/solver/geodesic_solver.h"
+
+namespace mem3dg {
+namespace solver {
+
+gcs::VertexData<double>
+GeodesicSolver::computeDistance(gcs::VertexPositionGeometry &vpg,
+                                const gcs::SurfacePoint &point) {
+  auto positions = toMatrix(vpg.inputVertexPositions);
+
+  bool isRefactor =
+      !heatSolver || referencePositions.rows() != positions.rows();
+  if (!isRefactor) {
+    if (tolerance > 0) {
+      double maxDisplacement =
+          (positions - referencePositions).rowwise().norm().maxCoeff();
+      isRefactor = maxDisplacement > tolerance * referenceEdgeLength;
+    } else {
+      isRefactor = positions != referencePositions;
+    }
+  }
+
+  if (isRefactor) {
+    heatSolver.reset(new gcs::HeatMethodDistanceSolver(vpg));
+    referencePositions = positions;
+    vpg.requireEdgeLengths();
+    referenceEdgeLength = vpg.edgeLengths.raw().mean();
+    vpg.unrequireEdgeLengths();
+    ++nMisses;
+  } else {
+    ++nHits;
+  }
+  return heatSolver->computeDistance(point);
+}
+
+} // namespace solver
+} // namespace mem3dg
@@ -0,0 +1,136 @@
+// Membrane Dynamics in 3D using Discrete Differential Geometry (Mem3DG)
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright (c) 2020:
+//     Laboratory for Computational Cellular Mechanobiology
+//     Cuncheng Zhu (cuzhu@eng.ucsd.edu)
+//     Christopher T. Lee (ctlee@ucsd.edu)
+//     Ravi Ramamoorthi (ravir@cs.ucsd.edu)
+//     Padmini Rangamani (prangamani@eng.ucsd.edu)
+//
+
+#include "mem3dg/solver/geometry_refresh.h"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+namespace mem3dg {
+namespace solver {
+
+namespace gcs = ::geometrycentral::surface;
+
+#define MEM3DG_GEOMETRY_QUANTITY(NAME, NEEDED)                                 \
+  quantities.push_back(Quantity{                                               \
+      #NAME, NEEDED,                                                           \
+      [](gcs::VertexPositionGeometry &vpg) { vpg.require##NAME(); },          \
+      [](gcs::VertexPositionGeometry &vpg) { vpg.unrequire##NAME(); }});
+
+GeometryRefreshPlanner::GeometryRefreshPlanner() {
+  auto always = [](const Parameters &p) { return true; };
+  auto never = [](const Parameters &p) { return false; };
+  // deviatoric energy and potential, and the anchor external force
+  auto isGaussianCurvature = [](const Parameters &p) {
+    return p.bending.Kd != 0 || p.bending.Kdc != 0 || p.external.Kf != 0;
+  };
+
+  // used by forces, energies and integrators
+  MEM3DG_GEOMETRY_QUANTITY(VertexIndices, always);
+  MEM3DG_GEOMETRY_QUANTITY(FaceIndices, always);
+  MEM3DG_GEOMETRY_QUANTITY(EdgeLengths, always);
+  MEM3DG_GEOMETRY_QUANTITY(FaceAreas, always);
+  MEM3DG_GEOMETRY_QUANTITY(FaceNormals, always);
+  MEM3DG_GEOMETRY_QUANTITY(HalfedgeCotanWeights, always);
+  MEM3DG_GEOMETRY_QUANTITY(EdgeDihedralAngles, always);
+  MEM3DG_GEOMETRY_QUANTITY(VertexNormals, always);
+  MEM3DG_GEOMETRY_QUANTITY(VertexDualAreas, always);
+  MEM3DG_GEOMETRY_QUANTITY(VertexMeanCurvatures, always);
+
+  // only used by some terms, output requires them on demand
+  MEM3DG_GEOMETRY_QUANTITY(VertexGaussianCurvatures, isGaussianCurvature);
+
+  // only used for visualization and output, required on demand. The cotan
+  // Laplacian of the diffusion potential is assembled in place by the System
+  MEM3DG_GEOMETRY_QUANTITY(CotanLaplacian, never);
+  MEM3DG_GEOMETRY_QUANTITY(CornerAngles, never);
+  MEM3DG_GEOMETRY_QUANTITY(CornerScaledAngles, never);
+  MEM3DG_GEOMETRY_QUANTITY(EdgeCotanWeights, never);
+  MEM3DG_GEOMETRY_QUANTITY(VertexLumpedMassMatrix, never);
+  MEM3DG_GEOMETRY_QUANTITY(DECOperators, never);
+}
+
+#undef MEM3DG_GEOMETRY_QUANTITY
+
+void GeometryRefreshPlanner::plan(const Parameters &p,
+                                  gcs::VertexPositionGeometry &vpg) {
+  for (Quantity &q : quantities) {
+    bool isNeeded = q.isNeeded(p);
+    if (isNeeded && !q.isPlanned) {
+      q.require(vpg);
+    } else if (!isNeeded && q.isPlanned) {
+      q.unrequire(vpg);
+    }
+    q.isPlanned = isNeeded;
+  }
+}
+
+void GeometryRefreshPlanner::refresh(gcs::VertexPositionGeometry &vpg) {
+  if (!isTiming) {
+    vpg.refreshQuantities();
+    for (Quantity &q : quantities) {
+      if (q.isPlanned)
+        ++q.nRefresh;
+    }
+    return;
+  }
+
+  // invalidate all quantities without recomputing the planned ones, then
+  // recompute them one at a time in the order of dependency
+  for (Quantity &q : quantities) {
+    if (q.isPlanned)
+      q.unrequire(vpg);
+  }
+  vpg.refreshQuantities();
+  for (Quantity &q : quantities) {
+    if (!q.isPlanned)
+      continue;
+    auto start = std::chrono::steady_clock::now();
+    q.require(vpg);
+    q.time += std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                            start)
+                  .count();
+    ++q.nRefresh;
+  }
+}
+
+void GeometryRefreshPlanner::release(gcs::VertexPositionGeometry &vpg) {
+  for (Quantity &q : quantities) {
+    if (q.isPlanned)
+      q.unrequire(vpg);
+    q.isPlanned = false;
+  }
+}
+
+std::map<std::string, double> GeometryRefreshPlanner::getTiming() const {
+  std::map<std::string, double> timing;
+  for (const Quantity &q : quantities) {
+    timing[q.name] = q.time;
+  }
+  return timing;
+}
+
+void GeometryRefreshPlanner::summarizeTiming() const {
+  std::cout << "Geometry refresh timing:" << std::endl;
+  for (const Quantity &q : quantities) {
+    std::cout << "  " << std::setw(26) << std::left << q.name
+              << (q.isPlanned ? "on " : "off") << std::setw(10) << std::right
+              << q.nRefresh << " refreshes" << std::setw(14) << q.time
+              << " s" << std::endl;
+  }
+}
+
+} // namespace solver
+} // namespace mem3dg
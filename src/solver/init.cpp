@@ -203,8 +203,10 @@ void System::saveRichData(std::string PathToSave, bool isJustGeometry) {
                         vpg->vertexDualAreas.raw().array());
     richData.addVertexProperty("mean_curvature", meanCurv);
     gcs::VertexData<double> gaussCurv(*mesh);
+    vpg->requireVertexGaussianCurvatures();
     gaussCurv.fromVector(vpg->vertexGaussianCurvatures.raw().array() /
                          vpg->vertexDualAreas.raw().array());
+    vpg->unrequireVertexGaussianCurvatures();
     richData.addVertexProperty("gauss_curvature", gaussCurv);
     richData.addVertexProperty("spon_curvature", H0);
 
@@ -261,20 +263,18 @@ void System::checkConfiguration() {
         "specifying x-y coordinate on closed surface may"
         "lead to ambiguity! Please check by visualizing it first!");
   }
-  if (parameters.selfAvoidance.mu != 0) {
+  if (parameters.selfAvoidance.mu != 0 && parameters.selfAvoidance.d > 0) {
+    // pairs closer than the limit distance from the cell list
+    auto positions = toMatrix(vpg->inputVertexPositions);
+    std::vector<std::size_t> offsets, neighbors;
+    CellList violationCellList;
+    violationCellList.build(positions, parameters.selfAvoidance.d);
+    violationCellList.findPairs(positions, parameters.selfAvoidance.d, offsets,
+                                neighbors);
+    topologyCache.requireRings(parameters.selfAvoidance.n);
     for (std::size_t i = 0; i < mesh->nVertices(); ++i) {
-      gc::Vertex vi{mesh->vertex(i)};
-      gc::VertexData<bool> neighborList(*mesh, false);
-      meshProcessor.meshMutator.markVertices(neighborList, vi,
-                                             parameters.selfAvoidance.n);
-      for (std::size_t j = i + 1; j < mesh->nVertices(); ++j) {
-        if (neighborList[j])
-          continue;
-        gc::Vertex vj{mesh->vertex(j)};
-        gc::Vector3 r =
-            vpg->inputVertexPositions[vj] - vpg->inputVertexPositions[vi];
-        double distance = gc::norm(r);
-        if (distance < parameters.selfAvoidance.d)
+      for (std::size_t k = offsets[i]; k < offsets[i + 1]; ++k) {
+        if (!topologyCache.isInRing(i, neighbors[k]))
           mem3dg_runtime_error(
               "Input mesh violates the self avoidance constraint!");
       }
@@ -324,8 +324,7 @@ void System::initConstants() {
   findThePoint(*vpg, geodesicDistanceFromPtInd, 1e18);
 
   // Initialize const geodesic distance
-  gcs::HeatMethodDistanceSolver heatSolver(*vpg);
-  geodesicDistanceFromPtInd = heatSolver.computeDistance(thePoint);
+  geodesicDistanceFromPtInd = geodesicSolver.computeDistance(*vpg, thePoint);
 
   // Initialize the constant mask based on distance from the point specified
   if (parameters.variation.radius != -1) {
@@ -402,10 +401,18 @@ void System::initConstants() {
   std::cout << "vol_init = " << volume << std::endl;
 }
 
+void System::refreshGeometry() {
+  Profiler::ScopedTimer timer(profiler, Profiler::RefreshGeometry);
+  geometryRefreshPlanner.isTiming = profiler.isEnabled;
+  geometryRefreshPlanner.plan(parameters, *vpg);
+  geometryRefreshPlanner.refresh(*vpg);
+}
+
 void System::updateConfigurations(bool isUpdateGeodesics) {
+  Profiler::ScopedTimer timer(profiler, Profiler::UpdateConfigurations);
 
   // refresh cached quantities after regularization
-  vpg->refreshQuantities();
+  refreshGeometry();
 
   // recompute floating "the vertex"
   if (parameters.point.isFloatVertex && isUpdateGeodesics) {
@@ -416,8 +423,9 @@ void System::updateConfigurations(bool isUpdateGeodesics) {
 
   // update geodesic distance
   if (isUpdateGeodesics) {
-    gcs::HeatMethodDistanceSolver heatSolver(*vpg);
-    geodesicDistanceFromPtInd = heatSolver.computeDistance(thePoint);
+    Profiler::ScopedTimer geodesicTimer(profiler, Profiler::UpdateGeodesics);
+    geodesicDistanceFromPtInd =
+        geodesicSolver.computeDistance(*vpg, thePoint);
   }
 
   // initialize/update external force
@@ -456,57 +464,20 @@ void System::updateConfigurations(bool isUpdateGeodesics) {
   }
 
   // Update protein density dependent quantities
-  if (parameters.bending.relation == "linear") {
-    H0.raw() = proteinDensity.raw() * parameters.bending.H0c;
-    Kb.raw() = parameters.bending.Kb +
-               parameters.bending.Kbc * proteinDensity.raw().array();
-    Kd.raw() = parameters.bending.Kd +
-               parameters.bending.Kdc * proteinDensity.raw().array();
-  } else if (parameters.bending.relation == "hill") {
-    Eigen::Matrix<double, Eigen::Dynamic, 1> proteinDensitySq =
-        (proteinDensity.raw().array() * proteinDensity.raw().array()).matrix();
-    H0.raw() = (parameters.bending.H0c * proteinDensitySq.array() /
-                (1 + proteinDensitySq.array()))
-                   .matrix();
-    Kb.raw() = (parameters.bending.Kb + parameters.bending.Kbc *
-                                            proteinDensitySq.array() /
-                                            (1 + proteinDensitySq.array()))
-                   .matrix();
-    Kd.raw() = (parameters.bending.Kd + parameters.bending.Kdc *
-                                            proteinDensitySq.array() /
-                                            (1 + proteinDensitySq.array()))
-                   .matrix();
-  } else {
-    mem3dg_runtime_error("updateVertexPosition: P.relation is invalid option!");
-  }
+  computeProteinDependentModuli(proteinDensity.raw(), H0.raw(), Kb.raw(),
+                                Kd.raw());
 
   /// initialize/update enclosed volume
   volume = getMeshVolume(*mesh, *vpg, true) + parameters.osmotic.V_res;
 
   // update global osmotic pressure
-  if (parameters.osmotic.isPreferredVolume) {
-    forces.osmoticPressure =
-        -(parameters.osmotic.Kv * (volume - parameters.osmotic.Vt) /
-              parameters.osmotic.Vt / parameters.osmotic.Vt +
-          parameters.osmotic.lambdaV);
-  } else if (parameters.osmotic.isConstantOsmoticPressure) {
-    forces.osmoticPressure = parameters.osmotic.Kv;
-  } else {
-    forces.osmoticPressure =
-        mem3dg::constants::i * mem3dg::constants::R * parameters.temperature *
-        (parameters.osmotic.n / volume - parameters.osmotic.cam);
-  }
+  forces.osmoticPressure = computeOsmoticPressure(volume);
 
   // initialize/update total surface area
   surfaceArea = vpg->faceAreas.raw().sum() + parameters.tension.A_res;
 
   // update global surface tension
-  forces.surfaceTension = parameters.tension.isConstantSurfaceTension
-                              ? parameters.tension.Ksg
-                              : parameters.tension.Ksg *
-                                        (surfaceArea - parameters.tension.At) /
-                                        parameters.tension.At +
-                                    parameters.tension.lambdaSG;
+  forces.surfaceTension = computeSurfaceTension(surfaceArea);
 
   // initialize/update line tension (on dual edge)
   if (parameters.dirichlet.eta != 0 && false) {
@@ -524,6 +495,58 @@ void System::updateConfigurations(bool isUpdateGeodesics) {
   }
 }
 
+void System::computeProteinDependentModuli(
+    const Eigen::Matrix<double, Eigen::Dynamic, 1> &protein,
+    Eigen::Matrix<double, Eigen::Dynamic, 1> &H0_,
+    Eigen::Matrix<double, Eigen::Dynamic, 1> &Kb_,
+    Eigen::Matrix<double, Eigen::Dynamic, 1> &Kd_) const {
+  if (parameters.bending.relation == "linear") {
+    H0_ = protein * parameters.bending.H0c;
+    Kb_ = (parameters.bending.Kb + parameters.bending.Kbc * protein.array())
+              .matrix();
+    Kd_ = (parameters.bending.Kd + parameters.bending.Kdc * protein.array())
+              .matrix();
+  } else if (parameters.bending.relation == "hill") {
+    Eigen::Matrix<double, Eigen::Dynamic, 1> proteinDensitySq =
+        (protein.array() * protein.array()).matrix();
+    H0_ = (parameters.bending.H0c * proteinDensitySq.array() /
+           (1 + proteinDensitySq.array()))
+              .matrix();
+    Kb_ = (parameters.bending.Kb + parameters.bending.Kbc *
+                                       proteinDensitySq.array() /
+                                       (1 + proteinDensitySq.array()))
+              .matrix();
+    Kd_ = (parameters.bending.Kd + parameters.bending.Kdc *
+                                       proteinDensitySq.array() /
+                                       (1 + proteinDensitySq.array()))
+              .matrix();
+  } else {
+    mem3dg_runtime_error("updateVertexPosition: P.relation is invalid option!");
+  }
+}
+
+double System::computeSurfaceTension(double area) const {
+  return parameters.tension.isConstantSurfaceTension
+             ? parameters.tension.Ksg
+             : parameters.tension.Ksg * (area - parameters.tension.At) /
+                       parameters.tension.At +
+                   parameters.tension.lambdaSG;
+}
+
+double System::computeOsmoticPressure(double volume) const {
+  if (parameters.osmotic.isPreferredVolume) {
+    return -(parameters.osmotic.Kv * (volume - parameters.osmotic.Vt) /
+                 parameters.osmotic.Vt / parameters.osmotic.Vt +
+             parameters.osmotic.lambdaV);
+  } else if (parameters.osmotic.isConstantOsmoticPressure) {
+    return parameters.osmotic.Kv;
+  } else {
+    return mem3dg::constants::i * mem3dg::constants::R *
+           parameters.temperature *
+           (parameters.osmotic.n / volume - parameters.osmotic.cam);
+  }
+}
+
 double System::inferTargetSurfaceArea() {
   double targetArea;
   if (isOpenMesh) {
@@ -40,6 +40,9 @@ bool ConjugateGradient::integrate() {
 
   signal(SIGINT, signalHandler);
 
+  // diagnostic force decompositions are only computed on save frames
+  Forces::DiagnosticScope diagnosticScope(system.forces, false);
+
 #ifdef __linux__
   // start the timer
   struct timeval start;
@@ -115,6 +118,15 @@ bool ConjugateGradient::integrate() {
   }
 #endif
 
+  // report the cost of line search
+  if (verbosity > 0 && nLineSearch > 0) {
+    std::cout << "Average energy evaluations per line search: "
+              << getAverageEnergyEvaluations() << std::endl;
+  }
+
+  // report the time spent in each phase
+  reportProfile();
+
   return SUCCESS;
 }
 
@@ -240,6 +252,24 @@ void ConjugateGradient::march() {
   system.updateConfigurations(false);
 }
 
+void ConjugateGradient::saveSchemeState(
+    std::map<std::string, double> &counters,
+    std::map<std::string, EigenVectorX1d> &arrays) const {
+  counters["countCG"] = static_cast<double>(countCG);
+  counters["pastNormSquared"] = pastNormSquared;
+}
+
+void ConjugateGradient::restoreSchemeState(
+    const std::map<std::string, double> &counters,
+    const std::map<std::string, EigenVectorX1d> &arrays) {
+  auto it = counters.find("countCG");
+  if (it != counters.end())
+    countCG = static_cast<std::size_t>(it->second);
+  it = counters.find("pastNormSquared");
+  if (it != counters.end())
+    pastNormSquared = it->second;
+}
+
 } // namespace integrator
 } // namespace solver
 } // namespace mem3dg
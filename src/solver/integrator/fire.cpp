@@ -0,0 +1,281 @@
+// Membrane Dynamics in 3D using Discrete Differential Geometry (Mem3DG)
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright (c) 2021:
+//     Laboratory for Computational Cellular Mechanobiology
+//     Cuncheng Zhu (cuzhu@eng.ucsd.edu)
+//     Christopher T. Lee (ctlee@ucsd.edu)
+//     Ravi Ramamoorthi (ravir@cs.ucsd.edu)
+//     Padmini Rangamani (prangamani@eng.ucsd.edu)
+//
+
+
+#include <Eigen/Core>
+#include <algorithm>
+#include <iostream>
+#include <math.h>
+
+#include <geometrycentral/surface/halfedge_mesh.h>
+#include <geometrycentral/surface/vertex_position_geometry.h>
+#include <geometrycentral/utilities/eigen_interop_helpers.h>
+#include <geometrycentral/utilities/vector3.h>
+
+#include "mem3dg/meshops.h"
+#include "mem3dg/solver/integrator/fire.h"
+#include "mem3dg/solver/integrator/integrator.h"
+#include "mem3dg/solver/system.h"
+
+namespace mem3dg {
+namespace solver {
+namespace integrator {
+namespace gc = ::geometrycentral;
+
+bool FIRE::integrate() {
+
+  signal(SIGINT, signalHandler);
+
+  // diagnostic force decompositions are only computed on save frames
+  Forces::DiagnosticScope diagnosticScope(system.forces, false);
+
+#ifdef __linux__
+  // start the timer
+  struct timeval start;
+  gettimeofday(&start, NULL);
+#endif
+
+  // initialize netcdf traj file
+#ifdef MEM3DG_WITH_NETCDF
+  if (verbosity > 0) {
+    createMutableNetcdfFile();
+    // print to console
+    std::cout << "Initialized NetCDF file at "
+              << outputDirectory + "/" + trajFileName << std::endl;
+  }
+#endif
+
+  // start the adaptation from the current parameters unless continuing it
+  // from a checkpoint
+  if (!isRestarted) {
+    mixing = initialMixing;
+    nDownhill = 0;
+  }
+
+  // time integration loop
+  for (;;) {
+
+    // Evaluate and threhold status data
+    status();
+
+    // Save files every tSave period and print some info
+    if (system.time - lastSave >= savePeriod || system.time == initialTime ||
+        EXIT) {
+      lastSave = system.time;
+      saveData();
+    }
+
+    // Process mesh every tProcessMesh period
+    if (system.time - lastProcessMesh > processMeshPeriod) {
+      lastProcessMesh = system.time;
+      system.mutateMesh();
+      system.updateConfigurations(false);
+    }
+
+    // update geodesics every tUpdateGeodesics period
+    if (system.time - lastUpdateGeodesics > updateGeodesicsPeriod) {
+      lastUpdateGeodesics = system.time;
+      system.updateConfigurations(true);
+    }
+
+    // break loop if EXIT flag is on
+    if (EXIT) {
+      break;
+    }
+
+    // step forward, restart the adaptation if the system changed
+    if (system.time == lastProcessMesh || system.time == lastUpdateGeodesics) {
+      system.time += 1e-10 * characteristicTimeStep;
+      restart();
+    } else {
+      march();
+    }
+  }
+
+  // return if optimization is sucessful
+  if (!SUCCESS) {
+    if (tolerance == 0) {
+      markFileName("_most");
+    } else {
+      markFileName("_failed");
+    }
+  }
+
+  // stop the timer and report time spent
+#ifdef __linux__
+  double duration = getDuration(start);
+  if (verbosity > 0) {
+    std::cout << "\nTotal integration time: " << duration << " seconds"
+              << std::endl;
+  }
+#endif
+
+  // report the time spent in each phase
+  reportProfile();
+
+  return SUCCESS;
+}
+
+void FIRE::checkParameters() {
+  if (system.parameters.dpd.gamma != 0) {
+    mem3dg_runtime_error("DPD has to be turned off for FIRE integration!");
+  }
+  if (system.parameters.proteinMobility != 1 &&
+      system.parameters.proteinMobility != 0) {
+    mem3dg_runtime_error("Protein mobility constant should "
+                         "be set to 1 for optimization!");
+  }
+  if (system.parameters.damping != 0) {
+    mem3dg_runtime_error("Damping to be 0 for FIRE integration!");
+  }
+  if (maxTimeStepFactor < 1 || timeStepIncrease < 1 || timeStepDecrease >= 1 ||
+      timeStepDecrease <= 0) {
+    mem3dg_runtime_error("FIRE requires maxTimeStepFactor >= 1, "
+                         "timeStepIncrease >= 1 and 0 < timeStepDecrease < 1!");
+  }
+  if (initialMixing <= 0 || initialMixing >= 1 || mixingDecrease <= 0 ||
+      mixingDecrease > 1) {
+    mem3dg_runtime_error(
+        "FIRE requires 0 < initialMixing < 1 and 0 < mixingDecrease <= 1!");
+  }
+  if (system.parameters.external.Kf != 0) {
+    mem3dg_runtime_error(
+        "External force can not be applied using energy optimization")
+  }
+}
+
+void FIRE::restart() {
+  system.velocity.fill({0, 0, 0});
+  system.proteinVelocity.raw().setZero();
+  mixing = initialMixing;
+  nDownhill = 0;
+}
+
+void FIRE::status() {
+  // compute summerized forces
+  system.computePhysicalForcing(timeStep);
+
+  // compute the area contraint error
+  areaDifference = abs(system.surfaceArea / system.parameters.tension.At - 1);
+  if (system.parameters.osmotic.isPreferredVolume) {
+    volumeDifference = abs(system.volume / system.parameters.osmotic.Vt - 1);
+    reducedVolumeThreshold(EXIT, isAugmentedLagrangian, areaDifference,
+                           volumeDifference, constraintTolerance, 1.3);
+  } else {
+    volumeDifference = abs(system.parameters.osmotic.n / system.volume /
+                               system.parameters.osmotic.cam -
+                           1.0);
+    pressureConstraintThreshold(EXIT, isAugmentedLagrangian, areaDifference,
+                                constraintTolerance, 1.3);
+  }
+
+  // exit if reached time
+  if (system.time > totalTime) {
+    std::cout << "\nReached time." << std::endl;
+    EXIT = true;
+    SUCCESS = false;
+  }
+
+  // compute the free energy of the system
+  system.computeTotalEnergy();
+
+  // backtracing for error
+  finitenessErrorBacktrace();
+}
+
+void FIRE::march() {
+  // masked generalized force, zero on the fixed degrees of freedom
+  auto velocity = toMatrix(system.velocity);
+  EigenVectorX1d &proteinVelocity = system.proteinVelocity.raw();
+  EigenVectorX3dr force =
+      system.parameters.variation.isShapeVariation
+          ? EigenVectorX3dr(toMatrix(system.forces.mechanicalForceVec))
+          : EigenVectorX3dr::Zero(velocity.rows(), 3);
+  EigenVectorX1d chemicalForce =
+      system.parameters.variation.isProteinVariation
+          ? EigenVectorX1d(system.parameters.proteinMobility *
+                           system.forces.chemicalPotential.raw())
+          : EigenVectorX1d::Zero(proteinVelocity.rows());
+  velocity = system.forces.maskForce(EigenVectorX3dr(velocity));
+  proteinVelocity = system.forces.maskProtein(EigenVectorX1d(proteinVelocity));
+
+  // power of the force, mix the velocity toward the force if downhill
+  double power = (velocity.array() * force.array()).sum() +
+                 proteinVelocity.dot(chemicalForce);
+  double velocityNorm =
+      std::sqrt(velocity.squaredNorm() + proteinVelocity.squaredNorm());
+  if (power > 0) {
+    double forceNorm =
+        std::sqrt(force.squaredNorm() + chemicalForce.squaredNorm());
+    if (forceNorm > 0) {
+      velocity = (1 - mixing) * velocity +
+                 mixing * velocityNorm / forceNorm * force;
+      proteinVelocity = (1 - mixing) * proteinVelocity +
+                        mixing * velocityNorm / forceNorm * chemicalForce;
+    }
+    if (++nDownhill > nDelay) {
+      timeStep = std::min(timeStep * timeStepIncrease,
+                          maxTimeStepFactor * characteristicTimeStep);
+      mixing *= mixingDecrease;
+    }
+  } else if (velocityNorm > 0) {
+    timeStep *= timeStepDecrease;
+    restart();
+  }
+  // from rest, i.e. the first step after a restart, the step is neutral
+
+  // semi-implicit Euler step with unit mass
+  velocity += timeStep * force;
+  proteinVelocity += timeStep * chemicalForce;
+  system.vpg->inputVertexPositions += system.velocity * timeStep;
+  system.proteinDensity += system.proteinVelocity * timeStep;
+  system.time += timeStep;
+  ++nIterations;
+
+  // regularization
+  if (system.meshProcessor.isMeshRegularize) {
+    system.computeRegularizationForce();
+    system.vpg->inputVertexPositions.raw() +=
+        system.forces.regularizationForce.raw();
+  }
+
+  // recompute cached values
+  system.updateConfigurations(false);
+}
+
+void FIRE::saveSchemeState(
+    std::map<std::string, double> &counters,
+    std::map<std::string, EigenVectorX1d> &arrays) const {
+  counters["mixing"] = mixing;
+  counters["nDownhill"] = static_cast<double>(nDownhill);
+  counters["nIterations"] = static_cast<double>(nIterations);
+}
+
+void FIRE::restoreSchemeState(
+    const std::map<std::string, double> &counters,
+    const std::map<std::string, EigenVectorX1d> &arrays) {
+  auto it = counters.find("mixing");
+  if (it != counters.end())
+    mixing = it->second;
+  it = counters.find("nDownhill");
+  if (it != counters.end())
+    nDownhill = static_cast<std::size_t>(it->second);
+  it = counters.find("nIterations");
+  if (it != counters.end())
+    nIterations = static_cast<std::size_t>(it->second);
+}
+
+} // namespace integrator
+} // namespace solver
+} // namespace mem3dg
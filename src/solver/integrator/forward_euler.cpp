@@ -38,6 +38,9 @@ bool Euler::integrate() {
 
   signal(SIGINT, signalHandler);
 
+  // diagnostic force decompositions are only computed on save frames
+  Forces::DiagnosticScope diagnosticScope(system.forces, false);
+
 #ifdef __linux__
   // start the timer
   struct timeval start;
@@ -136,6 +139,15 @@ bool Euler::integrate() {
   }
 #endif
 
+  // report the cost of line search
+  if (verbosity > 0 && nLineSearch > 0) {
+    std::cout << "Average energy evaluations per line search: "
+              << getAverageEnergyEvaluations() << std::endl;
+  }
+
+  // report the time spent in each phase
+  reportProfile();
+
   return SUCCESS;
 }
 
@@ -18,12 +18,14 @@
 #include "mem3dg/type_utilities.h"
 #include "mem3dg/version.h"
 
+#include <algorithm>
 #include <cmath>
 #include <geometrycentral/utilities/eigen_interop_helpers.h>
 
 #include <fstream>
 #include <iostream>
 #include <stdexcept>
+#include <type_traits>
 
 namespace mem3dg {
 namespace solver {
@@ -97,32 +99,29 @@ double Integrator::backtrack(
     }
   }
 
-  // calculate initial energy as reference level
-  gc::VertexData<gc::Vector3> initial_pos(*system.mesh);
-  initial_pos = system.vpg->inputVertexPositions;
-  gc::VertexData<double> initial_protein(*system.mesh,
-                                         system.proteinDensity.raw());
-  const double init_time = system.time;
+  // cache the initial state as reference level
+  lineSearchState.save(system);
+  const EigenVectorX3dr &initial_pos = lineSearchState.positions;
+  const EigenVectorX1d &initial_protein = lineSearchState.proteinDensity;
 
   // declare variables used in backtracking iterations
   double alpha = characteristicTimeStep;
   std::size_t count = 0;
+  double previousAlpha = 0, previousEnergy = 0;
 
   // zeroth iteration
-  if (system.parameters.variation.isShapeVariation) {
-    toMatrix(system.vpg->inputVertexPositions) += alpha * positionDirection;
-  }
-  if (system.parameters.variation.isProteinVariation) {
-    system.proteinDensity.raw() += alpha * chemicalDirection;
-  }
-  system.time += alpha;
-  system.updateConfigurations(false);
-  system.computePotentialEnergy();
+  const bool isShape = system.parameters.variation.isShapeVariation;
+  const bool isProtein = system.parameters.variation.isProteinVariation;
+  bool isSystemTouched = system.parameters.external.Kf != 0;
+  const double initialEnergy =
+      beginLineSearch(positionDirection, isShape, previousE);
+  double trialEnergy = evaluateLineSearchTrial(
+      alpha, positionDirection, chemicalDirection, isShape, isProtein);
 
   while (true) {
     // Wolfe condition fulfillment
-    if (system.energy.potentialEnergy <
-        (previousE.potentialEnergy + system.computeIntegratedPower(alpha) -
+    if (trialEnergy <
+        (initialEnergy -
          c1 * alpha * (positionProjection + chemicalProjection))) {
       break;
     }
@@ -131,37 +130,44 @@ double Integrator::backtrack(
     if (alpha < 1e-5 * characteristicTimeStep) {
       mem3dg_runtime_message("line search failure! Simulation "
                              "stopped. \n");
+      // the backtrace inspects the system at the failing trial
+      applyLineSearchTrial(alpha, positionDirection, chemicalDirection, isShape,
+                           isProtein);
       std::cout << "\nError backtrace using alpha: \n" << std::endl;
-      lineSearchErrorBacktrace(alpha, toMatrix(initial_pos),
-                               toMatrix(initial_protein), previousE, true);
+      lineSearchErrorBacktrace(alpha, initial_pos, initial_protein, previousE,
+                               true);
       std::cout << "\nError backtrace using characteristicTimeStep: \n"
                 << std::endl;
       lineSearchErrorBacktrace(characteristicTimeStep,
                                toMatrix(system.vpg->inputVertexPositions),
-                               toMatrix(initial_protein), previousE, true);
+                               initial_protein, previousE, true);
+      isSystemTouched = true;
       EXIT = true;
       SUCCESS = false;
       break;
     }
 
     // backtracking time step
-    alpha *= rho;
-    if (system.parameters.variation.isShapeVariation) {
-      toMatrix(system.vpg->inputVertexPositions) =
-          toMatrix(initial_pos) + alpha * positionDirection;
-    }
-    if (system.parameters.variation.isProteinVariation) {
-      system.proteinDensity.raw() =
-          toMatrix(initial_protein) + alpha * chemicalDirection;
-    }
-    system.time = init_time + alpha;
-    system.updateConfigurations(false);
-    system.computePotentialEnergy();
+    double trialAlpha = alpha;
+    alpha = isInterpolatingLineSearch
+                ? interpolateStepSize(
+                      initialEnergy, -(positionProjection + chemicalProjection),
+                      alpha, trialEnergy, previousAlpha, previousEnergy)
+                : rho * alpha;
+    previousAlpha = trialAlpha;
+    previousEnergy = trialEnergy;
+    trialEnergy = evaluateLineSearchTrial(
+        alpha, positionDirection, chemicalDirection, isShape, isProtein);
 
     // count the number of iterations
     count++;
   }
 
+  // record the number of energy evaluations
+  nLineSearch++;
+  system.profiler.count(Profiler::LineSearches);
+  nLineSearchEnergyEvaluations += count + 1;
+
   // report the backtracking if verbose
   if (alpha != characteristicTimeStep && verbosity > 3) {
     std::cout << "alpha: " << characteristicTimeStep << " -> " << alpha
@@ -173,18 +179,130 @@ double Integrator::backtrack(
   // If needed to test force-energy test
   const bool isDebug = false;
   if (isDebug) {
-    lineSearchErrorBacktrace(alpha, toMatrix(initial_pos),
-                             toMatrix(initial_protein), previousE, isDebug);
+    applyLineSearchTrial(alpha, positionDirection, chemicalDirection, isShape,
+                         isProtein);
+    lineSearchErrorBacktrace(alpha, initial_pos, initial_protein, previousE,
+                             isDebug);
+  }
+
+  // recover the initial configuration if the trials have touched it
+  if (isSystemTouched || isDebug) {
+    lineSearchState.restore(system);
+    system.updateConfigurations(false);
+    system.computePotentialEnergy();
   }
+  return alpha;
+}
+double Integrator::beginLineSearch(
+    const Eigen::Matrix<double, Eigen::Dynamic, 3> &positionDirection,
+    bool isShape, const Energy &previousE) {
+  // with external force the trials are evaluated by computePotentialEnergy
+  if (system.parameters.external.Kf != 0) {
+    return previousE.potentialEnergy;
+  }
+
+  // the steps never exceed the first trial step
+  double maxDisplacement =
+      (isShape && positionDirection.rows() > 0)
+          ? characteristicTimeStep *
+                positionDirection.rowwise().norm().maxCoeff()
+          : 0;
+  system.reserveTrialPairs(lineSearchState.positions, maxDisplacement);
+  return system.evaluatePotentialEnergy(lineSearchState.positions,
+                                        lineSearchState.proteinDensity);
+}
 
-  // recover the initial configuration
-  system.time = init_time;
-  system.proteinDensity = initial_protein;
-  system.vpg->inputVertexPositions = initial_pos;
+double Integrator::evaluateLineSearchTrial(
+    double alpha,
+    const Eigen::Matrix<double, Eigen::Dynamic, 3> &positionDirection,
+    const Eigen::Matrix<double, Eigen::Dynamic, 1> &chemicalDirection,
+    bool isShape, bool isProtein) {
+  Profiler::ScopedTimer timer(system.profiler, Profiler::LineSearchTrial);
+  system.profiler.count(Profiler::LineSearchTrials);
+  if (system.parameters.external.Kf == 0) {
+    // energy only evaluation, system stays at the line search origin
+    const EigenVectorX3dr *trialPositions = &lineSearchState.positions;
+    const EigenVectorX1d *trialProtein = &lineSearchState.proteinDensity;
+    if (isShape) {
+      lineSearchTrialState.positions =
+          lineSearchState.positions + alpha * positionDirection;
+      trialPositions = &lineSearchTrialState.positions;
+    }
+    if (isProtein) {
+      lineSearchTrialState.proteinDensity =
+          lineSearchState.proteinDensity + alpha * chemicalDirection;
+      trialProtein = &lineSearchTrialState.proteinDensity;
+    }
+    return system.evaluatePotentialEnergy(*trialPositions, *trialProtein);
+  }
+
+  // external force depends on the full configuration
+  applyLineSearchTrial(alpha, positionDirection, chemicalDirection, isShape,
+                       isProtein);
+  return isShape ? system.energy.potentialEnergy -
+                       system.computeIntegratedPower(alpha)
+                 : system.energy.potentialEnergy;
+}
+
+void Integrator::applyLineSearchTrial(
+    double alpha,
+    const Eigen::Matrix<double, Eigen::Dynamic, 3> &positionDirection,
+    const Eigen::Matrix<double, Eigen::Dynamic, 1> &chemicalDirection,
+    bool isShape, bool isProtein) {
+  if (isShape) {
+    toMatrix(system.vpg->inputVertexPositions) =
+        lineSearchState.positions + alpha * positionDirection;
+  }
+  if (isProtein) {
+    system.proteinDensity.raw() =
+        lineSearchState.proteinDensity + alpha * chemicalDirection;
+  }
+  system.time = lineSearchState.time + alpha;
   system.updateConfigurations(false);
   system.computePotentialEnergy();
-  return alpha;
 }
+
+double Integrator::interpolateStepSize(double initialEnergy,
+                                       double initialSlope, double alpha,
+                                       double energy, double previousAlpha,
+                                       double previousEnergy) const {
+  // fall back to halving when the trial energy is not usable
+  if (!std::isfinite(energy) || initialSlope >= 0) {
+    return 0.5 * alpha;
+  }
+
+  double nextAlpha;
+  double d1 = energy - initialEnergy - initialSlope * alpha;
+  if (previousAlpha == 0 || !std::isfinite(previousEnergy)) {
+    // minimizer of the quadratic through E(0), E'(0) and E(alpha)
+    nextAlpha = -initialSlope * alpha * alpha / (2 * d1);
+  } else {
+    // minimizer of the cubic through E(0), E'(0), E(alpha) and
+    // E(previousAlpha)
+    double d0 = previousEnergy - initialEnergy - initialSlope * previousAlpha;
+    double denominator =
+        alpha * alpha * previousAlpha * previousAlpha * (alpha - previousAlpha);
+    double a = (previousAlpha * previousAlpha * d1 - alpha * alpha * d0) /
+               denominator;
+    double b = (-previousAlpha * previousAlpha * previousAlpha * d1 +
+                alpha * alpha * alpha * d0) /
+               denominator;
+    if (a == 0) {
+      nextAlpha = -initialSlope / (2 * b);
+    } else {
+      double discriminant = b * b - 3 * a * initialSlope;
+      nextAlpha = (discriminant < 0) ? 0.5 * alpha
+                                     : (-b + std::sqrt(discriminant)) / (3 * a);
+    }
+  }
+
+  // safeguard against too small or too large reduction
+  if (!std::isfinite(nextAlpha)) {
+    return 0.5 * alpha;
+  }
+  return std::min(std::max(nextAlpha, 0.1 * alpha), 0.5 * alpha);
+}
+
 double Integrator::chemicalBacktrack(
     Eigen::Matrix<double, Eigen::Dynamic, 1> &&chemicalDirection, double rho,
     double c1) {
@@ -209,27 +327,27 @@ double Integrator::chemicalBacktrack(
                              .sum();
   }
 
-  // calculate initial energy as reference level
-  gc::VertexData<gc::Vector3> initial_pos(*system.mesh);
-  initial_pos = system.vpg->inputVertexPositions;
-  gc::VertexData<double> initial_protein(*system.mesh,
-                                         system.proteinDensity.raw());
-  const double init_time = system.time;
+  // cache the initial state as reference level
+  lineSearchState.save(system);
+  const EigenVectorX3dr &initial_pos = lineSearchState.positions;
+  const EigenVectorX1d &initial_protein = lineSearchState.proteinDensity;
 
   // declare variables used in backtracking iterations
   double alpha = characteristicTimeStep;
   std::size_t count = 0;
+  double previousAlpha = 0, previousEnergy = 0;
 
   // zeroth iteration
-  system.proteinDensity.raw() += alpha * chemicalDirection;
-  system.time += alpha;
-  system.updateConfigurations(false);
-  system.computePotentialEnergy();
+  const Eigen::Matrix<double, Eigen::Dynamic, 3> positionDirection;
+  bool isSystemTouched = system.parameters.external.Kf != 0;
+  const double initialEnergy =
+      beginLineSearch(positionDirection, false, previousE);
+  double trialEnergy = evaluateLineSearchTrial(alpha, positionDirection,
+                                               chemicalDirection, false, true);
 
   while (true) {
     // Wolfe condition fulfillment
-    if (system.energy.potentialEnergy <
-        (previousE.potentialEnergy - c1 * alpha * chemicalProjection)) {
+    if (trialEnergy < (initialEnergy - c1 * alpha * chemicalProjection)) {
       break;
     }
 
@@ -238,30 +356,43 @@ double Integrator::chemicalBacktrack(
       mem3dg_runtime_message(
           "\nchemicalBacktrack: line search failure! Simulation "
           "stopped. \n");
+      // the backtrace inspects the system at the failing trial
+      applyLineSearchTrial(alpha, positionDirection, chemicalDirection,
+                           false, true);
       std::cout << "\nError backtrace using alpha: \n" << std::endl;
-      lineSearchErrorBacktrace(alpha, toMatrix(initial_pos),
-                               toMatrix(initial_protein), previousE, true);
+      lineSearchErrorBacktrace(alpha, initial_pos, initial_protein, previousE,
+                               true);
       std::cout << "\nError backtrace using characteristicTimeStep: \n"
                 << std::endl;
-      lineSearchErrorBacktrace(characteristicTimeStep, toMatrix(initial_pos),
-                               toMatrix(initial_protein), previousE, true);
+      lineSearchErrorBacktrace(characteristicTimeStep, initial_pos,
+                               initial_protein, previousE, true);
+      isSystemTouched = true;
       EXIT = true;
       SUCCESS = false;
       break;
     }
 
     // backtracking time step
-    alpha *= rho;
-    system.proteinDensity.raw() =
-        toMatrix(initial_protein) + alpha * chemicalDirection;
-    system.time = init_time + alpha;
-    system.updateConfigurations(false);
-    system.computePotentialEnergy();
+    double trialAlpha = alpha;
+    alpha = isInterpolatingLineSearch
+                ? interpolateStepSize(initialEnergy, -chemicalProjection,
+                                      alpha, trialEnergy, previousAlpha,
+                                      previousEnergy)
+                : rho * alpha;
+    previousAlpha = trialAlpha;
+    previousEnergy = trialEnergy;
+    trialEnergy = evaluateLineSearchTrial(alpha, positionDirection,
+                                          chemicalDirection, false, true);
 
     // count the number of iterations
     count++;
   }
 
+  // record the number of energy evaluations
+  nLineSearch++;
+  system.profiler.count(Profiler::LineSearches);
+  nLineSearchEnergyEvaluations += count + 1;
+
   // report the backtracking if verbose
   if (alpha != characteristicTimeStep && verbosity > 3) {
     std::cout << "alpha: " << characteristicTimeStep << " -> " << alpha
@@ -272,16 +403,18 @@ double Integrator::chemicalBacktrack(
   const bool isDebug = false;
   if (isDebug) {
     std::cout << "\nchemicalBacktrack: debugging \n" << std::endl;
-    lineSearchErrorBacktrace(alpha, toMatrix(initial_pos),
-                             toMatrix(initial_protein), previousE, isDebug);
+    applyLineSearchTrial(alpha, positionDirection, chemicalDirection,
+                         false, true);
+    lineSearchErrorBacktrace(alpha, initial_pos, initial_protein, previousE,
+                             isDebug);
   }
 
-  // recover the initial configuration
-  system.time = init_time;
-  system.proteinDensity = initial_protein;
-  system.vpg->inputVertexPositions = initial_pos;
-  system.updateConfigurations(false);
-  system.computePotentialEnergy();
+  // recover the initial configuration if the trials have touched it
+  if (isSystemTouched || isDebug) {
+    lineSearchState.restore(system);
+    system.updateConfigurations(false);
+    system.computePotentialEnergy();
+  }
   return alpha;
 }
 
@@ -309,29 +442,28 @@ double Integrator::mechanicalBacktrack(
                              .sum();
   }
 
-  // calculate initial energy as reference level
-  gc::VertexData<gc::Vector3> initial_pos(*system.mesh);
-  initial_pos = system.vpg->inputVertexPositions;
-  gc::VertexData<double> initial_protein(*system.mesh,
-                                         system.proteinDensity.raw());
-  const double init_time = system.time;
+  // cache the initial state as reference level
+  lineSearchState.save(system);
+  const EigenVectorX3dr &initial_pos = lineSearchState.positions;
+  const EigenVectorX1d &initial_protein = lineSearchState.proteinDensity;
 
   // declare variables used in backtracking iterations
   double alpha = characteristicTimeStep;
   std::size_t count = 0;
+  double previousAlpha = 0, previousEnergy = 0;
 
   // zeroth iteration
-  toMatrix(system.vpg->inputVertexPositions) += alpha * positionDirection;
-  system.time += alpha;
-  system.updateConfigurations(false);
-  system.computePotentialEnergy();
+  const Eigen::Matrix<double, Eigen::Dynamic, 1> chemicalDirection;
+  bool isSystemTouched = system.parameters.external.Kf != 0;
+  const double initialEnergy =
+      beginLineSearch(positionDirection, true, previousE);
+  double trialEnergy = evaluateLineSearchTrial(alpha, positionDirection,
+                                               chemicalDirection, true, false);
 
   while (true) {
     // Wolfe condition fulfillment
-    if ((system.energy.potentialEnergy <
-         (previousE.potentialEnergy + system.computeIntegratedPower(alpha) -
-          c1 * alpha * positionProjection)) &&
-        std::isfinite(system.energy.potentialEnergy)) {
+    if ((trialEnergy < (initialEnergy - c1 * alpha * positionProjection)) &&
+        std::isfinite(trialEnergy)) {
       break;
     }
 
@@ -340,31 +472,43 @@ double Integrator::mechanicalBacktrack(
       mem3dg_runtime_message(
           "\nmechanicalBacktrack: line search failure! Simulation "
           "stopped. \n");
+      // the backtrace inspects the system at the failing trial
+      applyLineSearchTrial(alpha, positionDirection, chemicalDirection,
+                           true, false);
       std::cout << "\nError backtrace using alpha: \n" << std::endl;
-      lineSearchErrorBacktrace(alpha, toMatrix(initial_pos),
-                               toMatrix(initial_protein), previousE, true);
+      lineSearchErrorBacktrace(alpha, initial_pos, initial_protein, previousE,
+                               true);
       std::cout << "\nError backtrace using characterisiticTimeStep: \n"
                 << std::endl;
-      lineSearchErrorBacktrace(characteristicTimeStep, toMatrix(initial_pos),
-                               toMatrix(initial_protein), previousE, true);
+      lineSearchErrorBacktrace(characteristicTimeStep, initial_pos,
+                               initial_protein, previousE, true);
+      isSystemTouched = true;
       EXIT = true;
       SUCCESS = false;
       break;
     }
 
     // backtracking time step
-    alpha *= rho;
-    toMatrix(system.vpg->inputVertexPositions) =
-        toMatrix(initial_pos) + alpha * positionDirection;
-
-    system.time = init_time + alpha;
-    system.updateConfigurations(false);
-    system.computePotentialEnergy();
+    double trialAlpha = alpha;
+    alpha = isInterpolatingLineSearch
+                ? interpolateStepSize(initialEnergy, -positionProjection,
+                                      alpha, trialEnergy, previousAlpha,
+                                      previousEnergy)
+                : rho * alpha;
+    previousAlpha = trialAlpha;
+    previousEnergy = trialEnergy;
+    trialEnergy = evaluateLineSearchTrial(alpha, positionDirection,
+                                          chemicalDirection, true, false);
 
     // count the number of iterations
     count++;
   }
 
+  // record the number of energy evaluations
+  nLineSearch++;
+  system.profiler.count(Profiler::LineSearches);
+  nLineSearchEnergyEvaluations += count + 1;
+
   // report the backtracking if verbose
   if (alpha != characteristicTimeStep && verbosity > 3) {
     std::cout << "alpha: " << characteristicTimeStep << " -> " << alpha
@@ -375,22 +519,24 @@ double Integrator::mechanicalBacktrack(
   const bool isDebug = false;
   if (isDebug) {
     std::cout << "\nmechanicalBacktrack: debugging \n" << std::endl;
-    lineSearchErrorBacktrace(alpha, toMatrix(initial_pos),
-                             toMatrix(initial_protein), previousE, isDebug);
+    applyLineSearchTrial(alpha, positionDirection, chemicalDirection,
+                         true, false);
+    lineSearchErrorBacktrace(alpha, initial_pos, initial_protein, previousE,
+                             isDebug);
   }
 
-  // recover the initial configuration
-  system.time = init_time;
-  system.proteinDensity = initial_protein;
-  system.vpg->inputVertexPositions = initial_pos;
-  system.updateConfigurations(false);
-  system.computePotentialEnergy();
+  // recover the initial configuration if the trials have touched it
+  if (isSystemTouched || isDebug) {
+    lineSearchState.restore(system);
+    system.updateConfigurations(false);
+    system.computePotentialEnergy();
+  }
   return alpha;
 }
 
 void Integrator::lineSearchErrorBacktrace(
-    const double alpha, const EigenVectorX3dr currentPosition,
-    const EigenVectorX1d currentProteinDensity, const Energy previousEnergy,
+    const double alpha, const EigenVectorX3dr &currentPosition,
+    const EigenVectorX1d &currentProteinDensity, const Energy &previousEnergy,
     bool runAll) {
   std::cout << "\nlineSearchErrorBacktracking ..." << std::endl;
 
@@ -1084,9 +1230,15 @@ void Integrator::reducedVolumeThreshold(bool &EXIT,
 }
 
 void Integrator::saveData() {
+  Profiler::ScopedTimer timer(system.profiler, Profiler::SaveData);
   // threshold of verbosity level to output ply file
   int outputPly = 0;
 
+  // bring the diagnostic force decompositions up to date for output
+  if (verbosity > 0 && !system.forces.isDiagnostic) {
+    system.computeForceDiagnostics();
+  }
+
 #ifdef MEM3DG_WITH_NETCDF
   // save variable to netcdf traj file
   if (verbosity > 0) {
@@ -1107,6 +1259,7 @@ void Integrator::saveData() {
 
   // print in-progress information in the console
   if (verbosity > 1) {
+    system.vpg->requireVertexGaussianCurvatures();
     std::cout << "\n"
               << "t: " << system.time << ", "
               << "n: " << frame << ", "
@@ -1146,6 +1299,7 @@ void Integrator::saveData() {
               << "\n"
               << "phi: [" << system.proteinDensity.raw().minCoeff() << ","
               << system.proteinDensity.raw().maxCoeff() << "]" << std::endl;
+    system.vpg->unrequireVertexGaussianCurvatures();
     // << "COM: "
     // << gc::EigenMap<double,
     // 3>(f.vpg->inputVertexPositions).colwise().sum() /
@@ -1164,6 +1318,74 @@ void Integrator::saveData() {
   }
 
   frame++;
+
+  // restart point after the frame is complete
+  if (isWriteCheckpoint) {
+#ifdef MEM3DG_WITH_NETCDF
+    // the trajectory covers the frame of the checkpoint
+    if (trajFileWriter)
+      trajFileWriter->flush();
+#endif
+    saveCheckpoint(outputDirectory + "/checkpoint.bin");
+  }
+}
+
+void Integrator::saveCheckpoint(const std::string &fileName) {
+  std::map<std::string, double> counters{
+      {"frame", static_cast<double>(frame)},
+      {"trajFileFrame", static_cast<double>(trajFileFrame)},
+      {"timeStep", timeStep},
+      {"characteristicTimeStep", characteristicTimeStep},
+      {"dt_size2_ratio", dt_size2_ratio},
+      {"initialTime", initialTime},
+      {"lastSave", lastSave},
+      {"lastUpdateGeodesics", lastUpdateGeodesics},
+      {"lastProcessMesh", lastProcessMesh},
+      {"lastComputeAvoidingForce", lastComputeAvoidingForce},
+      {"initialMaximumForce", initialMaximumForce},
+      {"nLineSearch", static_cast<double>(nLineSearch)},
+      {"nLineSearchEnergyEvaluations",
+       static_cast<double>(nLineSearchEnergyEvaluations)}};
+  std::map<std::string, EigenVectorX1d> arrays;
+  saveSchemeState(counters, arrays);
+  system.saveCheckpoint(fileName, counters, arrays);
+}
+
+void Integrator::restoreCheckpoint(
+    const std::map<std::string, double> &counters,
+    const std::map<std::string, EigenVectorX1d> &arrays) {
+  auto restore = [&counters](const std::string &name, auto &counter) {
+    auto it = counters.find(name);
+    if (it != counters.end())
+      counter = static_cast<std::remove_reference_t<decltype(counter)>>(
+          it->second);
+  };
+  restore("frame", frame);
+  restore("trajFileFrame", trajFileFrame);
+  restore("timeStep", timeStep);
+  restore("characteristicTimeStep", characteristicTimeStep);
+  restore("dt_size2_ratio", dt_size2_ratio);
+  restore("initialTime", initialTime);
+  restore("lastSave", lastSave);
+  restore("lastUpdateGeodesics", lastUpdateGeodesics);
+  restore("lastProcessMesh", lastProcessMesh);
+  restore("lastComputeAvoidingForce", lastComputeAvoidingForce);
+  restore("initialMaximumForce", initialMaximumForce);
+  restore("nLineSearch", nLineSearch);
+  restore("nLineSearchEnergyEvaluations", nLineSearchEnergyEvaluations);
+  restoreSchemeState(counters, arrays);
+  isRestarted = true;
+}
+
+void Integrator::reportProfile() {
+  if (!system.profiler.isEnabled)
+    return;
+  if (verbosity > 0) {
+    system.profiler.summarize();
+  }
+  if (isWriteProfile) {
+    system.profiler.writeJson(outputDirectory + "/profile.json");
+  }
 }
 
 void Integrator::markFileName(std::string marker_str) {
@@ -1214,9 +1436,22 @@ void Integrator::createNetcdfFile() {
 }
 
 void Integrator::createMutableNetcdfFile() {
-  // initialize netcdf traj file
-  mutableTrajFile.createNewFile(outputDirectory + "/" + trajFileName,
-                                TrajFile::NcFile::replace);
+  if (isRestarted) {
+    // continue the trajectory of the checkpoint, frames written after it are
+    // overwritten
+    mutableTrajFile.open(outputDirectory + "/" + trajFileName,
+                         TrajFile::NcFile::write);
+  } else {
+    // initialize netcdf traj file
+    mutableTrajFile.settings = trajFileSettings;
+    mutableTrajFile.createNewFile(outputDirectory + "/" + trajFileName,
+                                  TrajFile::NcFile::replace);
+    trajFileFrame = 0;
+  }
+  if (isAsyncWrite) {
+    trajFileWriter.reset(new AsyncTrajFileWriter(
+        mutableTrajFile, asyncWriteQueueDepth, trajFileFrame));
+  }
   // mutableTrajFile.writeMask(toMatrix(f.forces.forceMask).rowwise().sum());
   // if (!f.mesh->hasBoundary()) {
   //   mutableTrajFile.writeRefSurfArea(f.parameters.tension.At);
@@ -1273,9 +1508,11 @@ void Integrator::saveNetcdfData() {
     trajFile.writeMeanCurvature(idx,
                                 system.vpg->vertexMeanCurvatures.raw().array() /
                                     system.vpg->vertexDualAreas.raw().array());
+    system.vpg->requireVertexGaussianCurvatures();
     trajFile.writeGaussCurvature(
         idx, system.vpg->vertexGaussianCurvatures.raw().array() /
                  system.vpg->vertexDualAreas.raw().array());
+    system.vpg->unrequireVertexGaussianCurvatures();
     trajFile.writeSponCurvature(idx, system.H0.raw());
     // fd.writeAngles(idx, f.vpg.cornerAngles.raw());
     // fd.writeH_H0_diff(idx,
@@ -1294,7 +1531,28 @@ void Integrator::saveNetcdfData() {
 }
 
 void Integrator::saveMutableNetcdfData() {
-  std::size_t idx = mutableTrajFile.nFrames();
+  Profiler::ScopedTimer timer(system.profiler, Profiler::SaveMutableNetcdfData);
+  if (trajFileWriter) {
+    // copy the frame and let the writer thread compress and write it
+    TrajFrame &frame = trajFileWriter->acquireFrame();
+    frame.time = system.time;
+    frame.velocity = toMatrix(system.velocity);
+    frame.hasExternalForce = system.parameters.external.Kf != 0;
+    if (frame.hasExternalForce)
+      frame.externalForce = toMatrix(system.forces.externalForceVec);
+    frame.coordinates = toMatrix(system.vpg->inputVertexPositions);
+    frame.topology = system.mesh->getFaceVertexMatrix<std::uint32_t>();
+    frame.proteinDensity = system.proteinDensity.raw();
+    trajFileWriter->submitFrame();
+    ++trajFileFrame;
+
+    // the last frame is on disk before the file is renamed or closed
+    if (EXIT)
+      trajFileWriter->flush();
+    return;
+  }
+
+  std::size_t idx = trajFileFrame++;
 
   // scalar quantities
   // write time
@@ -0,0 +1,333 @@
+// Membrane Dynamics in 3D using Discrete Differential Geometry (Mem3DG)
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright (c) 2021:
+//     Laboratory for Computational Cellular Mechanobiology
+//     Cuncheng Zhu (cuzhu@eng.ucsd.edu)
+//     Christopher T. Lee (ctlee@ucsd.edu)
+//     Ravi Ramamoorthi (ravir@cs.ucsd.edu)
+//     Padmini Rangamani (prangamani@eng.ucsd.edu)
+//
+
+
+#include <Eigen/Core>
+#include <iostream>
+#include <math.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <geometrycentral/surface/halfedge_mesh.h>
+#include <geometrycentral/surface/vertex_position_geometry.h>
+#include <geometrycentral/utilities/eigen_interop_helpers.h>
+#include <geometrycentral/utilities/vector3.h>
+
+#include "mem3dg/meshops.h"
+#include "mem3dg/solver/integrator/integrator.h"
+#include "mem3dg/solver/integrator/lbfgs.h"
+#include "mem3dg/solver/system.h"
+
+namespace mem3dg {
+namespace solver {
+namespace integrator {
+namespace gc = ::geometrycentral;
+
+bool LBFGS::integrate() {
+
+  signal(SIGINT, signalHandler);
+
+  // diagnostic force decompositions are only computed on save frames
+  Forces::DiagnosticScope diagnosticScope(system.forces, false);
+
+#ifdef __linux__
+  // start the timer
+  struct timeval start;
+  gettimeofday(&start, NULL);
+#endif
+
+  // initialize netcdf traj file
+#ifdef MEM3DG_WITH_NETCDF
+  if (verbosity > 0) {
+    createMutableNetcdfFile();
+    // print to console
+    std::cout << "Initialized NetCDF file at "
+              << outputDirectory + "/" + trajFileName << std::endl;
+  }
+#endif
+
+  // time integration loop
+  for (;;) {
+
+    // Evaluate and threhold status data
+    status();
+
+    // Save files every tSave period and print some info
+    if (system.time - lastSave >= savePeriod || system.time == initialTime ||
+        EXIT) {
+      lastSave = system.time;
+      saveData();
+    }
+
+    // Process mesh every tProcessMesh period
+    if (system.time - lastProcessMesh > processMeshPeriod) {
+      lastProcessMesh = system.time;
+      system.mutateMesh();
+      system.updateConfigurations(false);
+    }
+
+    // update geodesics every tUpdateGeodesics period
+    if (system.time - lastUpdateGeodesics > updateGeodesicsPeriod) {
+      lastUpdateGeodesics = system.time;
+      system.updateConfigurations(true);
+    }
+
+    // break loop if EXIT flag is on
+    if (EXIT) {
+      break;
+    }
+
+    // step forward, restart from gradient descent if the system changed
+    if (system.time == lastProcessMesh || system.time == lastUpdateGeodesics) {
+      system.time += 1e-10 * characteristicTimeStep;
+      resetHistory();
+    } else {
+      march();
+    }
+  }
+
+  // return if optimization is sucessful
+  if (!SUCCESS) {
+    if (tolerance == 0) {
+      markFileName("_most");
+    } else {
+      markFileName("_failed");
+    }
+  }
+
+  // stop the timer and report time spent
+#ifdef __linux__
+  double duration = getDuration(start);
+  if (verbosity > 0) {
+    std::cout << "\nTotal integration time: " << duration << " seconds"
+              << std::endl;
+  }
+#endif
+
+  // report the cost of line search
+  if (verbosity > 0 && nLineSearch > 0) {
+    std::cout << "Average energy evaluations per line search: "
+              << getAverageEnergyEvaluations() << std::endl;
+  }
+
+  // report the time spent in each phase
+  reportProfile();
+
+  return SUCCESS;
+}
+
+void LBFGS::checkParameters() {
+  if (system.parameters.dpd.gamma != 0) {
+    mem3dg_runtime_error("DPD has to be turned off for L-BFGS integration!");
+  }
+  if (system.parameters.proteinMobility != 1 &&
+      system.parameters.proteinMobility != 0) {
+    mem3dg_runtime_error("Protein mobility constant should "
+                         "be set to 1 for optimization!");
+  }
+  if (system.parameters.damping != 0) {
+    mem3dg_runtime_error("Damping to be 0 for L-BFGS integration!");
+  }
+  if (isBacktrack) {
+    if (rho >= 1 || rho <= 0 || c1 >= 1 || c1 <= 0) {
+      mem3dg_runtime_error("To backtrack, 0<rho<1 and 0<c1<1!");
+    }
+  }
+  if (historyLength < 1) {
+    mem3dg_runtime_error("historyLength > 0!");
+  }
+  if (system.parameters.external.Kf != 0) {
+    mem3dg_runtime_error(
+        "External force can not be applied using energy optimization")
+  }
+}
+
+EigenVectorX1d LBFGS::getForce() {
+  std::size_t n = system.mesh->nVertices();
+  EigenVectorX1d force = EigenVectorX1d::Zero(4 * n);
+  if (system.parameters.variation.isShapeVariation) {
+    EigenVectorX3dr mechanicalForceVec =
+        toMatrix(system.forces.mechanicalForceVec);
+    force.head(3 * n) =
+        Eigen::Map<const EigenVectorX1d>(mechanicalForceVec.data(), 3 * n);
+  }
+  if (system.parameters.variation.isProteinVariation) {
+    force.tail(n) = system.parameters.proteinMobility *
+                    system.forces.chemicalPotential.raw();
+  }
+  return force;
+}
+
+void LBFGS::resetHistory() {
+  sHistory.clear();
+  yHistory.clear();
+  rhoHistory.clear();
+  isPastStepValid = false;
+}
+
+void LBFGS::status() {
+  // compute summerized forces
+  system.computePhysicalForcing(timeStep);
+
+  // append the correction pair of the last step if it satisfies the
+  // curvature condition
+  EigenVectorX1d force = getForce();
+  if (isPastStepValid && pastForce.rows() == force.rows()) {
+    EigenVectorX1d y = pastForce - force;
+    double sTy = pastStep.dot(y);
+    if (sTy > 1e-12 * pastStep.norm() * y.norm()) {
+      sHistory.push_back(pastStep);
+      yHistory.push_back(y);
+      rhoHistory.push_back(1 / sTy);
+      if (sHistory.size() > historyLength) {
+        sHistory.pop_front();
+        yHistory.pop_front();
+        rhoHistory.pop_front();
+      }
+    }
+  } else if (pastForce.rows() != force.rows()) {
+    resetHistory();
+  }
+  pastForce = force;
+  isPastStepValid = false;
+
+  // compute the area contraint error
+  areaDifference = abs(system.surfaceArea / system.parameters.tension.At - 1);
+  if (system.parameters.osmotic.isPreferredVolume) {
+    volumeDifference = abs(system.volume / system.parameters.osmotic.Vt - 1);
+    reducedVolumeThreshold(EXIT, isAugmentedLagrangian, areaDifference,
+                           volumeDifference, constraintTolerance, 1.3);
+  } else {
+    volumeDifference = abs(system.parameters.osmotic.n / system.volume /
+                               system.parameters.osmotic.cam -
+                           1.0);
+    pressureConstraintThreshold(EXIT, isAugmentedLagrangian, areaDifference,
+                                constraintTolerance, 1.3);
+  }
+
+  // exit if reached time
+  if (system.time > totalTime) {
+    std::cout << "\nReached time." << std::endl;
+    EXIT = true;
+    SUCCESS = false;
+  }
+
+  // compute the free energy of the system
+  system.computeTotalEnergy();
+
+  // backtracing for error
+  finitenessErrorBacktrace();
+}
+
+void LBFGS::march() {
+  std::size_t n = system.mesh->nVertices();
+
+  // two-loop recursion, direction = H * force
+  EigenVectorX1d direction = pastForce;
+  std::size_t m = sHistory.size();
+  std::vector<double> alpha(m);
+  for (std::size_t i = m; i-- > 0;) {
+    alpha[i] = rhoHistory[i] * sHistory[i].dot(direction);
+    direction -= alpha[i] * yHistory[i];
+  }
+  if (m > 0) {
+    // initial inverse Hessian scaled by s^T y / y^T y of the latest pair
+    direction /= rhoHistory.back() * yHistory.back().squaredNorm();
+  }
+  for (std::size_t i = 0; i < m; ++i) {
+    double beta = rhoHistory[i] * yHistory[i].dot(direction);
+    direction += (alpha[i] - beta) * sHistory[i];
+  }
+
+  // restart from the steepest descent if not a descent direction
+  if (direction.dot(pastForce) <= 0) {
+    resetHistory();
+    direction = pastForce;
+  }
+
+  // backtrack replaces an uphill component with its bare gradient in place
+  Eigen::Matrix<double, Eigen::Dynamic, 3> positionDirection =
+      Eigen::Map<const EigenVectorX3dr>(direction.data(), n, 3);
+  Eigen::Matrix<double, Eigen::Dynamic, 1> chemicalDirection =
+      direction.tail(n);
+
+  // adjust time step if adopt adaptive time step based on mesh size
+  if (isAdaptiveStep) {
+    updateAdaptiveCharacteristicStep();
+  }
+
+  // time stepping on vertex position
+  if (isBacktrack) {
+    timeStep = backtrack(std::move(positionDirection),
+                         std::move(chemicalDirection), rho, c1);
+  } else {
+    timeStep = characteristicTimeStep;
+  }
+  toMatrix(system.velocity) = positionDirection;
+  system.proteinVelocity.raw() = chemicalDirection;
+  system.vpg->inputVertexPositions += system.velocity * timeStep;
+  system.proteinDensity += system.proteinVelocity * timeStep;
+  system.time += timeStep;
+  pastStep.resize(4 * n);
+  Eigen::Map<EigenVectorX3dr>(pastStep.data(), n, 3) =
+      timeStep * positionDirection;
+  pastStep.tail(n) = timeStep * chemicalDirection;
+  isPastStepValid = true;
+
+  // regularization
+  if (system.meshProcessor.isMeshRegularize) {
+    system.computeRegularizationForce();
+    system.vpg->inputVertexPositions.raw() +=
+        system.forces.regularizationForce.raw();
+  }
+
+  // recompute cached values
+  system.updateConfigurations(false);
+}
+
+void LBFGS::saveSchemeState(
+    std::map<std::string, double> &counters,
+    std::map<std::string, EigenVectorX1d> &arrays) const {
+  // the force and the step of the last iteration are recomputed by status()
+  counters["nHistory"] = static_cast<double>(sHistory.size());
+  for (std::size_t i = 0; i < sHistory.size(); ++i) {
+    arrays["s" + std::to_string(i)] = sHistory[i];
+    arrays["y" + std::to_string(i)] = yHistory[i];
+  }
+  EigenVectorX1d rho(rhoHistory.size());
+  for (std::size_t i = 0; i < rhoHistory.size(); ++i)
+    rho[i] = rhoHistory[i];
+  arrays["rhoHistory"] = rho;
+}
+
+void LBFGS::restoreSchemeState(
+    const std::map<std::string, double> &counters,
+    const std::map<std::string, EigenVectorX1d> &arrays) {
+  resetHistory();
+  auto it = counters.find("nHistory");
+  auto rho = arrays.find("rhoHistory");
+  if (it == counters.end() || rho == arrays.end())
+    return;
+  std::size_t nHistory = static_cast<std::size_t>(it->second);
+  for (std::size_t i = 0; i < nHistory; ++i) {
+    sHistory.push_back(arrays.at("s" + std::to_string(i)));
+    yHistory.push_back(arrays.at("y" + std::to_string(i)));
+    rhoHistory.push_back(rho->second[i]);
+  }
+}
+
+} // namespace integrator
+} // namespace solver
+} // namespace mem3dg
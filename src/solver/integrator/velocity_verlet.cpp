@@ -39,6 +39,9 @@ namespace gc = ::geometrycentral;
 bool VelocityVerlet::integrate() {
   signal(SIGINT, signalHandler);
 
+  // diagnostic force decompositions are only computed on save frames
+  Forces::DiagnosticScope diagnosticScope(system.forces, false);
+
 #ifdef __linux__
   // start the timer
   struct timeval start;
@@ -111,6 +114,9 @@ bool VelocityVerlet::integrate() {
   }
 #endif
 
+  // report the time spent in each phase
+  reportProfile();
+
   return SUCCESS;
 }
 
@@ -214,6 +220,27 @@ void VelocityVerlet::march() {
   // recompute cached values
   system.updateConfigurations(false);
 }
+void VelocityVerlet::saveSchemeState(
+    std::map<std::string, double> &counters,
+    std::map<std::string, EigenVectorX1d> &arrays) const {
+  counters["initialTotalEnergy"] = initialTotalEnergy;
+  EigenVectorX3dr force = gc::EigenMap<double, 3>(pastMechanicalForceVec);
+  arrays["pastMechanicalForceVec"] =
+      Eigen::Map<const EigenVectorX1d>(force.data(), force.size());
+}
+
+void VelocityVerlet::restoreSchemeState(
+    const std::map<std::string, double> &counters,
+    const std::map<std::string, EigenVectorX1d> &arrays) {
+  auto it = counters.find("initialTotalEnergy");
+  if (it != counters.end())
+    initialTotalEnergy = it->second;
+  auto force = arrays.find("pastMechanicalForceVec");
+  if (force != arrays.end())
+    toMatrix(pastMechanicalForceVec) = Eigen::Map<const EigenVectorX3dr>(
+        force->second.data(), force->second.size() / 3, 3);
+}
+
 } // namespace integrator
 } // namespace solver
 } // namespace mem3dg
@@ -41,8 +41,9 @@ bool MutableTrajFile::check_metadata() {
     mem3dg_runtime_error("NetCDF convention mismatch. This file does "
                          "not appear to be a valid Mem3DG trajectory.");
 
-  fd->getAtt(CONVENTIONS_VERSION_NAME).getValues(tmp);
-  if (tmp != CONVENTIONS_VERSION_VALUE)
+  fd->getAtt(CONVENTIONS_VERSION_NAME).getValues(conventionsVersion);
+  if (conventionsVersion != CONVENTIONS_VERSION_VALUE &&
+      conventionsVersion != CONVENTIONS_VERSION_LEGACY_VALUE)
     mem3dg_runtime_error(
         "Trajectory version mismatch. This file was generated with a "
         "different convention version.");
@@ -147,9 +147,24 @@ void Parameters::Variation::checkParameters() {
   }
 }
 
+void Parameters::SelfAvoidance::checkParameters() {
+  if (n > 2) {
+    mem3dg_runtime_error("Number of excluding neighborhood layers n can not "
+                         "exceed 2!");
+  }
+  if (r < 0) {
+    mem3dg_runtime_error("Interaction range r has to be nonnegative, or 0 to "
+                         "include all pairs!");
+  }
+  if (skin < 0) {
+    mem3dg_runtime_error("Skin distance has to be nonnegative!");
+  }
+}
+
 void Parameters::checkParameters(bool hasBoundary, size_t nVertex) {
   tension.checkParameters();
   osmotic.checkParameters();
+  selfAvoidance.checkParameters();
   variation.checkParameters();
   point.checkParameters();
   proteinDistribution.checkParameters(nVertex);
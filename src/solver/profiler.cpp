@@ -0,0 +1,105 @@
+// Membrane Dynamics in 3D using Discrete Differential Geometry (Mem3DG)
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright (c) 2020:
+//     Laboratory for Computational Cellular Mechanobiology
+//     Cuncheng Zhu (cuzhu@eng.ucsd.edu)
+//     Christopher T. Lee (ctlee@ucsd.edu)
+//     Ravi Ramamoorthi (ravir@cs.ucsd.edu)
+//     Padmini Rangamani (prangamani@eng.ucsd.edu)
+//
+
+
+#include "mem3dg/solver/profiler.h"
+
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+#include "mem3dg/macros.h"
+
+namespace mem3dg {
+namespace solver {
+
+const std::array<const char *, Profiler::nPhases> Profiler::phaseNames{
+    {"updateConfigurations", "refreshGeometry", "updateGeodesics",
+     "computePhysicalForcing", "computeMechanicalForces",
+     "computeChemicalPotentials", "computeSelfAvoidanceForce",
+     "computeDPDForces", "prescribeExternalForce", "computePotentialEnergy",
+     "evaluatePotentialEnergy", "lineSearchTrial", "mutateMesh",
+     "smoothenMesh", "saveData", "saveMutableNetcdfData"}};
+
+const std::array<const char *, Profiler::nCounters> Profiler::counterNames{
+    {"energyEvaluations", "lineSearches", "lineSearchTrials", "edgeFlips",
+     "edgeSplits", "edgeCollapses"}};
+
+void Profiler::reset() {
+  phases.fill(Phase());
+  counters.fill(0);
+}
+
+std::map<std::string, double> Profiler::getTiming() const {
+  std::map<std::string, double> timing;
+  for (std::size_t i = 0; i < nPhases; ++i) {
+    if (phases[i].nCalls > 0)
+      timing[phaseNames[i]] = phases[i].time;
+  }
+  return timing;
+}
+
+std::map<std::string, std::size_t> Profiler::getCounts() const {
+  std::map<std::string, std::size_t> counts;
+  for (std::size_t i = 0; i < nCounters; ++i) {
+    if (counters[i] > 0)
+      counts[counterNames[i]] = counters[i];
+  }
+  return counts;
+}
+
+void Profiler::summarize() const {
+  std::cout << "Profile:" << std::endl;
+  for (std::size_t i = 0; i < nPhases; ++i) {
+    if (phases[i].nCalls == 0)
+      continue;
+    std::cout << "  " << std::setw(26) << std::left << phaseNames[i]
+              << std::setw(10) << std::right << phases[i].nCalls << " calls"
+              << std::setw(14) << phases[i].time << " s" << std::endl;
+  }
+  for (std::size_t i = 0; i < nCounters; ++i) {
+    if (counters[i] == 0)
+      continue;
+    std::cout << "  " << std::setw(26) << std::left << counterNames[i]
+              << std::setw(10) << std::right << counters[i] << std::endl;
+  }
+}
+
+void Profiler::writeJson(const std::string &fileName) const {
+  std::ofstream file(fileName);
+  if (!file) {
+    mem3dg_runtime_error("Profiler: cannot open ", fileName, "!");
+  }
+  file << std::setprecision(10) << "{\n  \"phases\": {";
+  std::string separator = "\n";
+  for (std::size_t i = 0; i < nPhases; ++i) {
+    if (phases[i].nCalls == 0)
+      continue;
+    file << separator << "    \"" << phaseNames[i] << "\": {\"calls\": "
+         << phases[i].nCalls << ", \"time\": " << phases[i].time << "}";
+    separator = ",\n";
+  }
+  file << "\n  },\n  \"counters\": {";
+  separator = "\n";
+  for (std::size_t i = 0; i < nCounters; ++i) {
+    if (counters[i] == 0)
+      continue;
+    file << separator << "    \"" << counterNames[i] << "\": " << counters[i];
+    separator = ",\n";
+  }
+  file << "\n  }\n}\n";
+}
+
+} // namespace solver
+} // namespace mem3dg
@@ -218,6 +218,8 @@ bool System::edgeFlip() {
 
     if (meshProcessor.meshMutator.ifFlip(e, *vpg)) {
       bool sucess = mesh->flip(e);
+      if (sucess)
+        profiler.count(Profiler::EdgeFlips);
       isOrigEdge[e] = false;
       isFlipped = true;
       meshProcessor.meshMutator.markVertices(mutationMarker, he.tailVertex());
@@ -273,6 +275,7 @@ bool System::growMesh() {
       count++;
       // split the edge
       gcs::Vertex newVertex = mesh->splitEdgeTriangular(e).vertex();
+      profiler.count(Profiler::EdgeSplits);
 
       // update quantities
       // Note: think about conservation of energy, momentum and angular
@@ -304,6 +307,7 @@ bool System::growMesh() {
 
       if (newVertex != gcs::Vertex()) {
         count++;
+        profiler.count(Profiler::EdgeCollapses);
         // update quantities
         // Note: think about conservation of energy, momentum and angular
         // momentum
@@ -337,6 +341,7 @@ bool System::growMesh() {
 }
 
 void System::mutateMesh(size_t nRepetition) {
+  Profiler::ScopedTimer timer(profiler, Profiler::MutateMesh);
   for (size_t i = 0; i < nRepetition; ++i) {
     bool isGrown = false, isFlipped = false;
     mutationMarker.fill(false);
@@ -368,6 +373,7 @@ void System::mutateMesh(size_t nRepetition) {
 
 Eigen::Matrix<bool, Eigen::Dynamic, 1>
 System::smoothenMesh(double initStep, double target, size_t maxIteration) {
+  Profiler::ScopedTimer timer(profiler, Profiler::SmoothenMesh);
   // require nonzero bending rigidity in parameters
   if (Kb.raw().sum() == 0) {
     mem3dg_runtime_error(
@@ -378,12 +384,12 @@ System::smoothenMesh(double initStep, double target, size_t maxIteration) {
   double pastGradNorm = 1e10;
   size_t num_iter = 0;
   // compute bending forces
-  vpg->refreshQuantities();
+  refreshGeometry();
   computeMechanicalForces();
   EigenVectorX3dr pastForceVec = toMatrix(forces.bendingForceVec);
   // initialize smoothingMask
   Eigen::Matrix<bool, Eigen::Dynamic, 1> smoothingMask =
-      outlierMask(forces.bendingForce.raw(), 0.5);
+      outlierMask(forces.ontoNormal(pastForceVec), 0.5);
   isSmooth = (smoothingMask.cast<int>().sum() == 0);
   // initialize gradient and compute exit tolerance
   double gradNorm = computeNorm(toMatrix(forces.bendingForceVec));
@@ -400,9 +406,10 @@ System::smoothenMesh(double initStep, double target, size_t maxIteration) {
     }
 
     // compute bending force if smoothingMask is true
-    vpg->refreshQuantities();
+    refreshGeometry();
     forces.bendingForceVec.fill({0, 0, 0});
     forces.bendingForce.raw().setZero();
+    computeHalfedgeVariationalVectors();
     for (std::size_t i = 0; i < mesh->nVertices(); ++i) {
       if (smoothingMask[i]) {
         computeMechanicalForces(i);
@@ -493,6 +500,12 @@ void System::localSmoothing(const gcs::Halfedge &he, std::size_t num,
 }
 
 void System::globalUpdateAfterMutation() {
+  // rebuild the flat connectivity
+  topologyCache.build(*mesh);
+  cotanLaplacianAssembler.buildPattern(topologyCache);
+  geodesicSolver.invalidate();
+  isSelfAvoidanceNeighborsStale = true;
+
   // update the velocity
   velocity = forces.maskForce(velocity); // important: velocity interpolation
                                          // contaminate the zero velocity
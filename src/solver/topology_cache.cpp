@@ -0,0 +1,180 @@
+// Membrane Dynamics in 3D using Discrete Differential Geometry (Mem3DG)
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright (c) 2020:
+//     Laboratory for Computational Cellular Mechanobiology
+//     Cuncheng Zhu (cuzhu@eng.ucsd.edu)
+//     Christopher T. Lee (ctlee@ucsd.edu)
+//     Ravi Ramamoorthi (ravir@cs.ucsd.edu)
+//     Padmini Rangamani (prangamani@eng.ucsd.edu)
+//
+
+#include "mem3dg/solver/topology_cache.h"
+
+#include <algorithm>
+
+#include "geometrycentral/surface/halfedge_element_types.h"
+
+namespace mem3dg {
+namespace solver {
+
+namespace gcs = ::geometrycentral::surface;
+
+void MeshTopologyCache::build(gcs::ManifoldSurfaceMesh &mesh) {
+  mesh.compress();
+  // keep the previous one-ring to find the vertices with changed neighborhood
+  std::size_t nVerticesOld = nVertices;
+  std::vector<std::size_t> vertexOffsetsOld, neighborVerticesOld;
+  if (hasRings) {
+    vertexOffsetsOld.swap(vertexOffsets);
+    neighborVerticesOld.swap(neighborVertices);
+  }
+
+  nVertices = mesh.nVertices();
+  nHalfedges = mesh.nHalfedges();
+  nFaces = mesh.nFaces();
+
+  // per halfedge connectivity
+  halfedgeNext.resize(nHalfedges);
+  halfedgeTwin.resize(nHalfedges);
+  halfedgeVertex.resize(nHalfedges);
+  halfedgeFace.resize(nHalfedges);
+  for (std::size_t i = 0; i < nHalfedges; ++i) {
+    gcs::Halfedge he = mesh.halfedge(i);
+    halfedgeNext[i] = he.next().getIndex();
+    halfedgeTwin[i] = he.twin().getIndex();
+    halfedgeVertex[i] = he.tailVertex().getIndex();
+    halfedgeFace[i] = he.isInterior() ? he.face().getIndex() : nFaces;
+  }
+
+  // per face connectivity
+  faceVertices.resize(3 * nFaces);
+  for (std::size_t f = 0; f < nFaces; ++f) {
+    gcs::Halfedge he = mesh.face(f).halfedge();
+    for (std::size_t k = 0; k < 3; ++k) {
+      faceVertices[3 * f + k] = he.tailVertex().getIndex();
+      he = he.next();
+    }
+  }
+
+  // one-ring offsets
+  vertexOffsets.resize(nVertices + 1);
+  isBoundaryVertex.resize(nVertices);
+  vertexOffsets[0] = 0;
+  for (std::size_t i = 0; i < nVertices; ++i) {
+    gcs::Vertex v = mesh.vertex(i);
+    isBoundaryVertex[i] = v.isBoundary();
+    vertexOffsets[i + 1] = vertexOffsets[i] + v.degree();
+  }
+
+  // one-ring entries
+  std::size_t nEntries = vertexOffsets[nVertices];
+  outgoingHalfedges.resize(nEntries);
+  neighborVertices.resize(nEntries);
+  oppositeVertices.resize(nEntries);
+  faces.resize(nEntries);
+  edges.resize(nEntries);
+  isInteriorHalfedge.resize(nEntries);
+  isBoundaryEdge.resize(nEntries);
+  for (std::size_t i = 0; i < nVertices; ++i) {
+    std::size_t k = vertexOffsets[i];
+    for (gcs::Halfedge he : mesh.vertex(i).outgoingHalfedges()) {
+      outgoingHalfedges[k] = he.getIndex();
+      neighborVertices[k] = he.tipVertex().getIndex();
+      oppositeVertices[k] = he.next().next().vertex().getIndex();
+      faces[k] = he.face().getIndex();
+      edges[k] = he.edge().getIndex();
+      isInteriorHalfedge[k] = he.isInterior();
+      isBoundaryEdge[k] = he.edge().isBoundary();
+      ++k;
+    }
+  }
+
+  // update the cached n-rings
+  if (!hasRings) {
+    return;
+  } else if (nVertices != nVerticesOld) {
+    hasRings = false;
+    requireRings(ringLayer);
+    return;
+  }
+  std::vector<std::uint8_t> isChanged(nVertices, false);
+  std::vector<std::size_t> ringOld, ringNew;
+  for (std::size_t i = 0; i < nVertices; ++i) {
+    ringOld.assign(neighborVerticesOld.begin() + vertexOffsetsOld[i],
+                   neighborVerticesOld.begin() + vertexOffsetsOld[i + 1]);
+    ringNew.assign(neighborVertices.begin() + begin(i),
+                   neighborVertices.begin() + end(i));
+    std::sort(ringOld.begin(), ringOld.end());
+    std::sort(ringNew.begin(), ringNew.end());
+    isChanged[i] = (ringOld != ringNew);
+  }
+  // n-ring of a vertex changes iff its (n-1)-ring has changed one-ring
+  std::vector<std::uint8_t> isAffected(nVertices, false);
+  for (std::size_t i = 0; i < nVertices; ++i) {
+    if (!isChanged[i] || ringLayer == 0)
+      continue;
+    collectRing(i, ringLayer - 1, ringNew);
+    for (std::size_t j : ringNew)
+      isAffected[j] = true;
+  }
+  std::vector<std::size_t> ringOffsetsOld, ringVerticesOld;
+  ringOffsetsOld.swap(ringOffsets);
+  ringVerticesOld.swap(ringVertices);
+  ringOffsets.assign(nVertices + 1, 0);
+  nRingUpdates = 0;
+  for (std::size_t i = 0; i < nVertices; ++i) {
+    if (isAffected[i]) {
+      collectRing(i, ringLayer, ringNew);
+      ringVertices.insert(ringVertices.end(), ringNew.begin(), ringNew.end());
+      ++nRingUpdates;
+    } else {
+      ringVertices.insert(ringVertices.end(),
+                          ringVerticesOld.begin() + ringOffsetsOld[i],
+                          ringVerticesOld.begin() + ringOffsetsOld[i + 1]);
+    }
+    ringOffsets[i + 1] = ringVertices.size();
+  }
+}
+
+void MeshTopologyCache::requireRings(std::size_t layer) {
+  if (hasRings && ringLayer == layer)
+    return;
+  ringLayer = layer;
+  ringOffsets.assign(nVertices + 1, 0);
+  ringVertices.clear();
+  std::vector<std::size_t> ring;
+  for (std::size_t i = 0; i < nVertices; ++i) {
+    collectRing(i, layer, ring);
+    ringVertices.insert(ringVertices.end(), ring.begin(), ring.end());
+    ringOffsets[i + 1] = ringVertices.size();
+  }
+  nRingUpdates = nVertices;
+  hasRings = true;
+}
+
+void MeshTopologyCache::collectRing(std::size_t i, std::size_t layer,
+                                    std::vector<std::size_t> &ring) const {
+  if (layer > 2)
+    mem3dg_runtime_error("max layer number is 2!");
+  ring.clear();
+  ring.push_back(i);
+  if (layer > 0) {
+    for (std::size_t k = begin(i); k < end(i); ++k) {
+      std::size_t j = neighborVertices[k];
+      ring.push_back(j);
+      if (layer > 1) {
+        ring.insert(ring.end(), neighborVertices.begin() + begin(j),
+                    neighborVertices.begin() + end(j));
+      }
+    }
+  }
+  std::sort(ring.begin(), ring.end());
+  ring.erase(std::unique(ring.begin(), ring.end()), ring.end());
+}
+
+} // namespace solver
+} // namespace mem3dg
@@ -42,7 +42,8 @@ bool TrajFile::check_metadata() {
                          "not appear to be a valid Mem3DG trajectory.");
 
   fd->getAtt(CONVENTIONS_VERSION_NAME).getValues(tmp);
-  if (tmp != CONVENTIONS_VERSION_VALUE)
+  if (tmp != CONVENTIONS_VERSION_VALUE &&
+      tmp != CONVENTIONS_VERSION_LEGACY_VALUE)
     mem3dg_runtime_error(
         "Trajectory version mismatch. This file was generated with a "
         "different convention version.");
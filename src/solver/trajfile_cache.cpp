@@ -0,0 +1,240 @@
+// Membrane Dynamics in 3D using Discrete Differential Geometry (Mem3DG)
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright (c) 2020:
+//     Laboratory for Computational Cellular Mechanobiology
+//     Cuncheng Zhu (cuzhu@eng.ucsd.edu)
+//     Christopher T. Lee (ctlee@ucsd.edu)
+//     Ravi Ramamoorthi (ravir@cs.ucsd.edu)
+//     Padmini Rangamani (prangamani@eng.ucsd.edu)
+//
+
+
+/**
+ * @file  trajfile_cache.cpp
+ * @brief Random access cache of mutable trajectory frames
+ *
+ */
+
+#ifdef MEM3DG_WITH_NETCDF
+
+#include <algorithm>
+#include <exception>
+#include <utility>
+
+#include "mem3dg/solver/trajfile_cache.h"
+
+namespace mem3dg {
+namespace solver {
+
+std::uint64_t hashTopology(const EigenVectorX3ur &topology) {
+  std::uint64_t hash = 14695981039346656037ULL;
+  auto mix = [&hash](std::uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+      hash ^= (value >> (8 * i)) & 0xFF;
+      hash *= 1099511628211ULL;
+    }
+  };
+  mix(static_cast<std::uint32_t>(topology.rows()));
+  for (Eigen::Index i = 0; i < topology.size(); ++i)
+    mix(topology.data()[i]);
+  return hash;
+}
+
+TrajFrameCache::TrajFrameCache(const std::string &filename,
+                               std::size_t capacity_, std::size_t nPrefetch_)
+    : file(MutableTrajFile::openReadOnly(filename)),
+      nFrames_(file.nFrames()), capacity(std::max<std::size_t>(capacity_, 1)),
+      nPrefetch(std::min(nPrefetch_, capacity - 1)) {
+  if (nPrefetch > 0)
+    worker = std::thread(&TrajFrameCache::run, this);
+}
+
+TrajFrameCache::~TrajFrameCache() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    isStopping = true;
+    prefetchQueue.clear();
+  }
+  prefetchRequested.notify_one();
+  if (worker.joinable())
+    worker.join();
+}
+
+std::shared_ptr<const TrajFrameCache::Frame>
+TrajFrameCache::getFrame(std::size_t idx) {
+  if (idx >= nFrames_)
+    mem3dg_runtime_error("Frame index exceeds the number of frames!");
+
+  std::shared_ptr<const Frame> frame;
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    // wait for the prefetching thread rather than reading the frame twice
+    frameLoaded.wait(lock, [&] { return loading.count(idx) == 0; });
+    frame = findFrame(idx);
+    if (frame) {
+      ++nHits;
+    } else {
+      ++nMisses;
+      loading.insert(idx);
+    }
+  }
+
+  if (!frame) {
+    try {
+      frame = readFrame(idx);
+    } catch (...) {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        loading.erase(idx);
+      }
+      frameLoaded.notify_all();
+      throw;
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      insertFrame(idx, frame);
+      loading.erase(idx);
+    }
+    frameLoaded.notify_all();
+  }
+
+  schedulePrefetch(idx);
+  return frame;
+}
+
+std::shared_ptr<const TrajFrameCache::Frame>
+TrajFrameCache::readFrame(std::size_t idx) {
+  auto frame = std::make_shared<Frame>();
+  std::size_t revision;
+  {
+    std::lock_guard<std::mutex> lock(fileMutex);
+    frame->time = file.getTime(idx);
+    revision = file.getTopologyRevision(idx);
+    frame->coordinates = file.getCoords(idx);
+    frame->velocity = file.getVelocity(idx);
+    frame->proteinDensity = file.getProteinDensity(idx);
+  }
+
+  // frames of a cached topology revision are not read again
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = revisions.find(revision);
+    if (it != revisions.end()) {
+      frame->topology = it->second.first.lock();
+      frame->topologyHash = it->second.second;
+    }
+  }
+  if (frame->topology)
+    return frame;
+
+  EigenVectorX3ur topology;
+  {
+    std::lock_guard<std::mutex> lock(fileMutex);
+    topology = file.getTopology(idx);
+  }
+
+  // share the topology with cached frames of the same connectivity
+  frame->topologyHash = hashTopology(topology);
+  std::lock_guard<std::mutex> lock(mutex);
+  auto it = topologies.find(frame->topologyHash);
+  std::shared_ptr<const EigenVectorX3ur> shared;
+  if (it != topologies.end())
+    shared = it->second.lock();
+  if (shared && shared->rows() == topology.rows() && *shared == topology) {
+    frame->topology = std::move(shared);
+  } else {
+    frame->topology =
+        std::make_shared<const EigenVectorX3ur>(std::move(topology));
+    topologies[frame->topologyHash] = frame->topology;
+  }
+  revisions[revision] = std::make_pair(frame->topology, frame->topologyHash);
+  return frame;
+}
+
+std::shared_ptr<const TrajFrameCache::Frame>
+TrajFrameCache::findFrame(std::size_t idx) {
+  auto it = frames.find(idx);
+  if (it == frames.end())
+    return nullptr;
+  recency.splice(recency.begin(), recency, it->second.second);
+  return it->second.first;
+}
+
+void TrajFrameCache::insertFrame(std::size_t idx,
+                                 std::shared_ptr<const Frame> frame) {
+  if (frames.count(idx) != 0)
+    return;
+  recency.push_front(idx);
+  frames.emplace(idx, std::make_pair(std::move(frame), recency.begin()));
+  while (frames.size() > capacity) {
+    frames.erase(recency.back());
+    recency.pop_back();
+  }
+  // drop the entries of topologies no longer used by any frame
+  for (auto it = topologies.begin(); it != topologies.end();) {
+    if (it->second.expired())
+      it = topologies.erase(it);
+    else
+      ++it;
+  }
+  for (auto it = revisions.begin(); it != revisions.end();) {
+    if (it->second.first.expired())
+      it = revisions.erase(it);
+    else
+      ++it;
+  }
+}
+
+void TrajFrameCache::schedulePrefetch(std::size_t idx) {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    // only the frames following the latest request are of interest
+    prefetchQueue.clear();
+    for (std::size_t i = idx + 1; i <= idx + nPrefetch && i < nFrames_; ++i) {
+      if (frames.count(i) == 0 && loading.count(i) == 0)
+        prefetchQueue.push_back(i);
+    }
+    if (prefetchQueue.empty())
+      return;
+  }
+  prefetchRequested.notify_one();
+}
+
+void TrajFrameCache::run() {
+  std::unique_lock<std::mutex> lock(mutex);
+  for (;;) {
+    prefetchRequested.wait(
+        lock, [this] { return !prefetchQueue.empty() || isStopping; });
+    if (isStopping)
+      return;
+
+    std::size_t idx = prefetchQueue.front();
+    prefetchQueue.pop_front();
+    if (frames.count(idx) != 0 || loading.count(idx) != 0)
+      continue;
+    loading.insert(idx);
+    lock.unlock();
+
+    std::shared_ptr<const Frame> frame;
+    try {
+      frame = readFrame(idx);
+    } catch (const std::exception &) {
+      // the error is raised again if the frame is requested
+    }
+    lock.lock();
+
+    if (frame)
+      insertFrame(idx, std::move(frame));
+    loading.erase(idx);
+    frameLoaded.notify_all();
+  }
+}
+
+} // namespace solver
+} // namespace mem3dg
+
+#endif
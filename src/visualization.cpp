@@ -19,6 +19,7 @@
 
 #include "mem3dg/solver/mesh_process.h"
 #include "mem3dg/solver/mutable_trajfile.h"
+#include "mem3dg/solver/trajfile_cache.h"
 #include "polyscope/polyscope.h"
 #include "polyscope/surface_mesh.h"
 #include "polyscope/view.h"
@@ -71,10 +72,12 @@ void visualize(mem3dg::solver::System &f) {
       ->addVertexScalarQuantity("mean_curvature",
                                 f.vpg->vertexMeanCurvatures.raw().array() /
                                     f.vpg->vertexDualAreas.raw().array());
+  f.vpg->requireVertexGaussianCurvatures();
   polyscope::getSurfaceMesh("Membrane")
       ->addVertexScalarQuantity("gauss_curvature",
                                 f.vpg->vertexGaussianCurvatures.raw().array() /
                                     f.vpg->vertexDualAreas.raw().array());
+  f.vpg->unrequireVertexGaussianCurvatures();
   polyscope::getSurfaceMesh("Membrane")
       ->addVertexScalarQuantity("spon_curvature", f.H0);
   polyscope::getSurfaceMesh("Membrane")
@@ -87,6 +90,10 @@ void visualize(mem3dg::solver::System &f) {
       ->addVertexScalarQuantity("physical_force", fn);
   polyscope::getSurfaceMesh("Membrane")
       ->addVertexScalarQuantity("bending_rigidity", f.Kb);
+  // quantities not required by the solver
+  f.vpg->requireVertexLumpedMassMatrix();
+  f.vpg->requireCotanLaplacian();
+  f.vpg->requireEdgeCotanWeights();
   polyscope::getSurfaceMesh("Membrane")
       ->addVertexScalarQuantity(
           "-lapH(smoothing)",
@@ -102,6 +109,11 @@ void visualize(mem3dg::solver::System &f) {
       ->addEdgeScalarQuantity("cotan weight", f.vpg->edgeCotanWeights);
   polyscope::getSurfaceMesh("Membrane")
       ->addEdgeScalarQuantity("edge_length", f.vpg->edgeLengths);
+  // polyscope keeps its own copy, release the quantities so that they are not
+  // refreshed on every step
+  f.vpg->unrequireVertexLumpedMassMatrix();
+  f.vpg->unrequireCotanLaplacian();
+  f.vpg->unrequireEdgeCotanWeights();
   polyscope::getSurfaceMesh("Membrane")
       ->addFaceCountQuantity(
           "the point", std::vector<std::pair<std::size_t, int>>{std::make_pair(
@@ -287,6 +299,10 @@ int animate_ply(std::string frameDir, const Quantities &options,
 
 #ifdef MEM3DG_WITH_NETCDF
 
+/// Topology of the mesh registered from a trajectory frame cache, kept alive
+/// such that the cache hands out the same matrix for the same connectivity
+static std::shared_ptr<const mem3dg::EigenVectorX3ur> registeredTopology;
+
 int animate_nc(std::string &filename, const Quantities &options,
                float transparency, float fov, float edgeWidth) {
 
@@ -296,8 +312,8 @@ int animate_nc(std::string &filename, const Quantities &options,
   // Read netcdf trajectory file
   // mem3dg::solver::TrajFile fd =
   //     mem3dg::solver::TrajFile::openReadOnly(filename);
-  mem3dg::solver::MutableTrajFile fd =
-      mem3dg::solver::MutableTrajFile::openReadOnly(filename);
+  // the viewer reads no other NetCDF file, so frames can be prefetched
+  mem3dg::solver::TrajFrameCache fd(filename, 64, 8);
 
   // Initialize visualization variables
   int prevFrame = 0;
@@ -483,6 +499,7 @@ polyscope::SurfaceMesh *registerSurfaceMesh(mem3dg::solver::TrajFile &fd,
   polyscope::SurfaceMesh *polyscopeMesh =
       polyscope::registerSurfaceMesh("Mesh", coords, topo_frame);
   // polyscopeMesh->setEnabled(true);
+  registeredTopology.reset();
 
   if (options.ref_coord) {
     mem3dg::EigenVectorX3dr refcoords = fd.getRefcoordinate();
@@ -556,6 +573,28 @@ polyscope::SurfaceMesh *registerSurfaceMesh(mem3dg::solver::MutableTrajFile &fd,
   polyscope::SurfaceMesh *polyscopeMesh =
       polyscope::registerSurfaceMesh("Mesh", coords, topo_frame);
   // polyscopeMesh->setEnabled(true);
+  registeredTopology.reset();
+
+  return polyscopeMesh;
+}
+
+polyscope::SurfaceMesh *
+registerSurfaceMesh(mem3dg::solver::TrajFrameCache &cache, int idx,
+                    const Quantities &options) {
+  if (idx >= cache.nFrames()) {
+    idx = 0;
+  }
+
+  auto frame = cache.getFrame(idx);
+  if (registeredTopology == frame->topology &&
+      polyscope::hasSurfaceMesh("Mesh")) {
+    polyscope::SurfaceMesh *polyscopeMesh = polyscope::getSurfaceMesh("Mesh");
+    polyscopeMesh->updateVertexPositions(frame->coordinates);
+    return polyscopeMesh;
+  }
+  polyscope::SurfaceMesh *polyscopeMesh = polyscope::registerSurfaceMesh(
+      "Mesh", frame->coordinates, *frame->topology);
+  registeredTopology = frame->topology;
 
   return polyscopeMesh;
 }
@@ -584,6 +623,19 @@ void play(polyscope::SurfaceMesh *&polyscopeMesh,
   }
   wait(waitTime);
 }
+
+void play(polyscope::SurfaceMesh *&polyscopeMesh,
+          mem3dg::solver::TrajFrameCache &fd, int &idx, int &waitTime,
+          Quantities options, bool &toggle) {
+
+  polyscopeMesh = registerSurfaceMesh(fd, idx, options);
+  idx++;
+  if (idx >= fd.nFrames()) {
+    idx = 0;
+    toggle = !toggle;
+  }
+  wait(waitTime);
+}
 #endif
 
 void wait(unsigned timeout) {
@@ -0,0 +1,348 @@
+// Membrane Dynamics in 3D using Discrete Differential Geometry (Mem3DG)
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright (c) 2020:
+//     Laboratory for Computational Cellular Mechanobiology
+//     Cuncheng Zhu (cuzhu@eng.ucsd.edu)
+//     Christopher T. Lee (ctlee@ucsd.edu)
+//     Ravi Ramamoorthi (ravir@cs.ucsd.edu)
+//     Padmini Rangamani (prangamani@eng.ucsd.edu)
+//
+
+
+#include <algorithm>
+#include <fstream>
+
+#include <benchmark/benchmark.h>
+
+#include "mem3dg/constants.h"
+#include "mem3dg/mem3dg"
+#include "mem3dg/type_utilities.h"
+#include <Eigen/Core>
+
+namespace mem3dg {
+namespace solver {
+
+/// Benchmarked meshes, selected by the first benchmark argument
+enum BenchmarkMesh { Icosphere = 0, Cylinder = 1, Hexagon = 2 };
+
+/**
+ * @brief Construct a system on the benchmark mesh with all the commonly used
+ * energy terms turned on
+ *
+ * @param mesh  type of mesh, see BenchmarkMesh
+ * @param nSub  refinement level of the mesh
+ */
+std::unique_ptr<System> makeBenchmarkSystem(int mesh, int nSub) {
+  Eigen::Matrix<std::size_t, Eigen::Dynamic, 3> topologyMatrix;
+  Eigen::Matrix<double, Eigen::Dynamic, 3> vertexMatrix;
+  switch (mesh) {
+  case Icosphere:
+    std::tie(topologyMatrix, vertexMatrix) = getIcosphereMatrix(1, nSub);
+    break;
+  case Cylinder:
+    std::tie(topologyMatrix, vertexMatrix) =
+        getCylinderMatrix(1, 4 << nSub, 4 << nSub);
+    break;
+  case Hexagon:
+    std::tie(topologyMatrix, vertexMatrix) = getHexagonMatrix(1, nSub);
+    break;
+  default:
+    mem3dg_runtime_error("Unknown benchmark mesh!");
+  }
+
+  Parameters p;
+  p.bending.Kbc = 8.22e-5;
+  p.bending.Kd = 8.22e-5;
+  p.adsorption.epsilon = -1e-3;
+  p.aggregation.chi = -1e-4;
+  p.dirichlet.eta = 1e-4;
+  p.selfAvoidance.mu = 1e-5;
+  p.selfAvoidance.d = 0.01;
+  p.dpd.gamma = 1;
+  p.variation.isProteinVariation = true;
+  p.proteinMobility = 1;
+  p.proteinDistribution.protein0 = Eigen::MatrixXd::Constant(1, 1, 0.5);
+
+  return std::unique_ptr<System>(
+      new System(topologyMatrix, vertexMatrix, p, 0));
+}
+
+/**
+ * @brief Mesh types and refinement levels shared by all benchmarks
+ */
+void meshArguments(benchmark::internal::Benchmark *b) {
+  b->ArgNames({"mesh", "nSub"});
+  for (int mesh : {Icosphere, Cylinder, Hexagon})
+    for (int nSub : {2, 3, 4})
+      b->Args({mesh, nSub});
+  b->Unit(benchmark::kMicrosecond);
+}
+
+/**
+ * @brief Report the mesh size alongside the timing
+ */
+void setMeshCounters(benchmark::State &state, const System &f) {
+  state.counters["nVertices"] = f.mesh->nVertices();
+  state.counters["vertexRate"] = benchmark::Counter(
+      f.mesh->nVertices(), benchmark::Counter::kIsIterationInvariantRate);
+}
+
+static void BM_SystemStartup(benchmark::State &state) {
+  // construction includes mesh smoothing and the self-avoidance check
+  for (auto _ : state)
+    benchmark::DoNotOptimize(makeBenchmarkSystem(Icosphere, state.range(0)));
+}
+BENCHMARK(BM_SystemStartup)
+    ->ArgName("nSub")
+    ->DenseRange(3, 6)
+    ->Unit(benchmark::kMillisecond);
+
+static void BM_ComputeMechanicalForces(benchmark::State &state) {
+  auto f = makeBenchmarkSystem(state.range(0), state.range(1));
+  for (auto _ : state) {
+    f->computeMechanicalForces();
+    benchmark::ClobberMemory();
+  }
+  setMeshCounters(state, *f);
+}
+BENCHMARK(BM_ComputeMechanicalForces)->Apply(meshArguments);
+
+static void BM_ComputeMechanicalForcesThreads(benchmark::State &state) {
+  auto f = makeBenchmarkSystem(Icosphere, state.range(0));
+  f->nThreads = state.range(1);
+  for (auto _ : state) {
+    f->computeMechanicalForces();
+    benchmark::ClobberMemory();
+  }
+  setMeshCounters(state, *f);
+}
+BENCHMARK(BM_ComputeMechanicalForcesThreads)
+    ->ArgNames({"nSub", "nThreads"})
+    ->ArgsProduct({{4, 5}, {1, 2, 4, 8}})
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+
+static void BM_ComputeChemicalPotentials(benchmark::State &state) {
+  auto f = makeBenchmarkSystem(state.range(0), state.range(1));
+  for (auto _ : state) {
+    f->computeChemicalPotentials();
+    benchmark::ClobberMemory();
+  }
+  setMeshCounters(state, *f);
+}
+BENCHMARK(BM_ComputeChemicalPotentials)->Apply(meshArguments);
+
+static void BM_ComputePotentialEnergy(benchmark::State &state) {
+  auto f = makeBenchmarkSystem(state.range(0), state.range(1));
+  for (auto _ : state)
+    benchmark::DoNotOptimize(f->computePotentialEnergy());
+  setMeshCounters(state, *f);
+}
+BENCHMARK(BM_ComputePotentialEnergy)->Apply(meshArguments);
+
+static void BM_UpdateConfigurations(benchmark::State &state) {
+  auto f = makeBenchmarkSystem(state.range(0), state.range(1));
+  for (auto _ : state) {
+    f->updateConfigurations();
+    benchmark::ClobberMemory();
+  }
+  setMeshCounters(state, *f);
+}
+BENCHMARK(BM_UpdateConfigurations)->Apply(meshArguments);
+
+static void BM_ComputeSelfAvoidanceForce(benchmark::State &state) {
+  auto f = makeBenchmarkSystem(state.range(0), state.range(1));
+  for (auto _ : state) {
+    f->computeSelfAvoidanceForce();
+    benchmark::ClobberMemory();
+  }
+  setMeshCounters(state, *f);
+}
+BENCHMARK(BM_ComputeSelfAvoidanceForce)->Apply(meshArguments);
+
+static void BM_SelfAvoidanceCellList(benchmark::State &state) {
+  auto f = makeBenchmarkSystem(Icosphere, state.range(0));
+  // fixed interaction range, so that the cost per vertex stays constant
+  f->parameters.selfAvoidance.r = 0.1;
+  for (auto _ : state) {
+    f->updateSelfAvoidanceNeighbors();
+    f->computeSelfAvoidanceForce();
+    benchmark::ClobberMemory();
+  }
+  setMeshCounters(state, *f);
+}
+BENCHMARK(BM_SelfAvoidanceCellList)
+    ->ArgName("nSub")
+    ->DenseRange(2, 5)
+    ->Unit(benchmark::kMicrosecond);
+
+static void BM_ComputeDPDForces(benchmark::State &state) {
+  auto f = makeBenchmarkSystem(state.range(0), state.range(1));
+  for (auto _ : state) {
+    f->computeDPDForces(1e-5);
+    benchmark::ClobberMemory();
+  }
+  setMeshCounters(state, *f);
+}
+BENCHMARK(BM_ComputeDPDForces)->Apply(meshArguments);
+
+static void BM_MutateMesh(benchmark::State &state) {
+  std::unique_ptr<System> f;
+  for (auto _ : state) {
+    // mutation changes the mesh, start every iteration from the same state
+    state.PauseTiming();
+    f = makeBenchmarkSystem(state.range(0), state.range(1));
+    f->meshProcessor.meshMutator.flipNonDelaunay = true;
+    f->meshProcessor.meshMutator.splitLarge = true;
+    f->meshProcessor.meshMutator.targetFaceArea =
+        0.5 * f->surfaceArea / f->mesh->nFaces();
+    f->meshProcessor.summarizeStatus();
+    state.ResumeTiming();
+
+    f->mutateMesh();
+  }
+  setMeshCounters(state, *f);
+}
+BENCHMARK(BM_MutateMesh)->Apply(meshArguments);
+
+static void BM_SmoothenMesh(benchmark::State &state) {
+  std::unique_ptr<System> f;
+  for (auto _ : state) {
+    state.PauseTiming();
+    f = makeBenchmarkSystem(state.range(0), state.range(1));
+    state.ResumeTiming();
+
+    benchmark::DoNotOptimize(f->smoothenMesh(0.01, 0.1, 10));
+  }
+  setMeshCounters(state, *f);
+}
+BENCHMARK(BM_SmoothenMesh)->Apply(meshArguments);
+
+/**
+ * @brief Construct a system relaxing to a reduced volume of 0.7, the setup of
+ * the integrator tests
+ *
+ * @param nSub  refinement level of the icosphere
+ */
+std::unique_ptr<System> makeRelaxationSystem(int nSub) {
+  Eigen::Matrix<std::size_t, Eigen::Dynamic, 3> topologyMatrix;
+  Eigen::Matrix<double, Eigen::Dynamic, 3> vertexMatrix;
+  std::tie(topologyMatrix, vertexMatrix) = getIcosphereMatrix(1, nSub);
+
+  Parameters p;
+  p.bending.Kbc = 8.22e-5;
+  p.tension.Ksg = 0.1;
+  p.tension.At = 4.0 * constants::PI;
+  p.osmotic.isPreferredVolume = true;
+  p.osmotic.Kv = 0.01;
+  p.osmotic.Vt = 4.0 / 3.0 * constants::PI * 0.7;
+
+  return std::unique_ptr<System>(
+      new System(topologyMatrix, vertexMatrix, p, 0));
+}
+
+/**
+ * @brief Wall time of a minimizer to reach the tolerance of 1e-3
+ */
+template <typename Minimizer>
+static void BM_Relaxation(benchmark::State &state) {
+  const double dt = 0.5, T = 50, tSave = 10, tol = 1e-3;
+  std::unique_ptr<System> f;
+  double simulationTime = 0;
+  bool isSuccess = false;
+  for (auto _ : state) {
+    state.PauseTiming();
+    f = makeRelaxationSystem(state.range(0));
+    Minimizer integrator{*f, dt, T, tSave, tol, "."};
+    integrator.verbosity = 0;
+    state.ResumeTiming();
+
+    isSuccess = integrator.integrate();
+    simulationTime = f->time;
+  }
+  state.counters["success"] = isSuccess;
+  state.counters["simulationTime"] = simulationTime;
+  setMeshCounters(state, *f);
+}
+static void BM_RelaxationFIRE(benchmark::State &state) {
+  BM_Relaxation<integrator::FIRE>(state);
+}
+static void BM_RelaxationConjugateGradient(benchmark::State &state) {
+  BM_Relaxation<integrator::ConjugateGradient>(state);
+}
+BENCHMARK(BM_RelaxationFIRE)
+    ->ArgName("nSub")
+    ->DenseRange(2, 3)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_RelaxationConjugateGradient)
+    ->ArgName("nSub")
+    ->DenseRange(2, 3)
+    ->Unit(benchmark::kMillisecond);
+
+#ifdef MEM3DG_WITH_NETCDF
+static void BM_MutableTrajFileWriteFrame(benchmark::State &state) {
+  auto f = makeBenchmarkSystem(state.range(0), state.range(1));
+  MutableTrajFile fd;
+  fd.createNewFile("benchmark.nc", netCDF::NcFile::replace);
+  std::size_t idx = 0;
+  for (auto _ : state) {
+    fd.writeTime(idx, f->time);
+    fd.writeVelocity(idx, f->velocity);
+    fd.writeCoords(idx, *f->vpg);
+    fd.writeTopology(idx, *f->mesh);
+    fd.writeProteinDensity(idx, f->proteinDensity);
+    fd.sync();
+    ++idx;
+  }
+  fd.close();
+  setMeshCounters(state, *f);
+}
+BENCHMARK(BM_MutableTrajFileWriteFrame)->Apply(meshArguments);
+
+static void BM_MutableTrajFileWriteSettings(benchmark::State &state) {
+  auto f = makeBenchmarkSystem(Icosphere, 4);
+  MutableTrajFile fd;
+  for (auto settings : {&fd.settings.coordinates, &fd.settings.velocity,
+                        &fd.settings.proteinDensity}) {
+    settings->precision =
+        static_cast<TrajVariableSettings::Precision>(state.range(0));
+    settings->compressionLevel = state.range(1);
+  }
+  fd.settings.topology.compressionLevel = state.range(1);
+  fd.createNewFile("benchmark_settings.nc", netCDF::NcFile::replace);
+  std::size_t idx = 0;
+  for (auto _ : state) {
+    fd.writeTime(idx, f->time);
+    fd.writeVelocity(idx, f->velocity);
+    fd.writeCoords(idx, *f->vpg);
+    fd.writeTopology(idx, *f->mesh);
+    fd.writeProteinDensity(idx, f->proteinDensity);
+    fd.sync();
+    ++idx;
+  }
+  fd.close();
+
+  std::ifstream file("benchmark_settings.nc",
+                     std::ios::binary | std::ios::ate);
+  state.counters["bytesPerFrame"] =
+      static_cast<double>(file.tellg()) / std::max<std::size_t>(idx, 1);
+  // uncompressed size of the frames in double precision
+  const std::size_t frameBytes =
+      (7 * f->mesh->nVertices() + 1) * sizeof(double) +
+      3 * f->mesh->nFaces() * sizeof(std::uint32_t);
+  state.SetBytesProcessed(idx * frameBytes);
+}
+BENCHMARK(BM_MutableTrajFileWriteSettings)
+    ->ArgNames({"precision", "compression"})
+    ->ArgsProduct({{TrajVariableSettings::Double, TrajVariableSettings::Float,
+                    TrajVariableSettings::Fixed},
+                   {0, 1, 5, 9}})
+    ->Unit(benchmark::kMicrosecond);
+#endif
+
+} // namespace solver
+} // namespace mem3dg
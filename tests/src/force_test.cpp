@@ -131,6 +131,139 @@ TEST_F(ForceTest, ConservativeForcesTest) {
   //   1e-12);
 };
 
+/**
+ * @brief Test whether multithreaded force assembly is bitwise identical to the
+ * serial one
+ */
+TEST_F(ForceTest, ParallelForceAssemblyTest) {
+  std::size_t nSub = 0;
+  mem3dg::solver::System f(topologyMatrix, vertexMatrix, p, nSub);
+
+  f.nThreads = 1;
+  f.computeMechanicalForces();
+  EigenVectorX3dr serialForceVec = toMatrix(f.forces.bendingForceVec);
+  EigenVectorX3dr serialDeviatoricVec = toMatrix(f.forces.deviatoricForceVec);
+  EigenVectorX1d serialOsmoticForce = toMatrix(f.forces.osmoticForce);
+
+  for (std::size_t nThreads : {2, 4, 8}) {
+    f.nThreads = nThreads;
+    f.computeMechanicalForces();
+    EXPECT_TRUE(toMatrix(f.forces.bendingForceVec) == serialForceVec);
+    EXPECT_TRUE(toMatrix(f.forces.deviatoricForceVec) == serialDeviatoricVec);
+    EXPECT_TRUE(toMatrix(f.forces.osmoticForce) == serialOsmoticForce);
+  }
+};
+
+/**
+ * @brief Test whether the kernel specialized on the enabled terms agrees with
+ * the full kernel when the disabled terms are zero
+ */
+TEST_F(ForceTest, SpecializedForceKernelTest) {
+  std::size_t nSub = 0;
+  p.bending.Kd = 0;
+  p.bending.Kdc = 0;
+  p.aggregation.chi = 0;
+  mem3dg::solver::System f(topologyMatrix, vertexMatrix, p, nSub);
+  EXPECT_EQ(f.getMechanicalForceTerms(),
+            System::AdsorptionTerm | System::LineCapillaryTerm);
+
+  f.computeMechanicalForces();
+  EigenVectorX3dr bendingForceVec = toMatrix(f.forces.bendingForceVec);
+  EigenVectorX3dr adsorptionForceVec = toMatrix(f.forces.adsorptionForceVec);
+  EigenVectorX3dr lineCapillaryForceVec =
+      toMatrix(f.forces.lineCapillaryForceVec);
+
+  for (std::size_t i = 0; i < f.mesh->nVertices(); ++i)
+    f.computeMechanicalForcesKernel<System::AllTerms>(i);
+  EXPECT_TRUE(toMatrix(f.forces.bendingForceVec) == bendingForceVec);
+  EXPECT_TRUE(toMatrix(f.forces.adsorptionForceVec) == adsorptionForceVec);
+  EXPECT_TRUE(toMatrix(f.forces.lineCapillaryForceVec) ==
+              lineCapillaryForceVec);
+  EXPECT_EQ(toMatrix(f.forces.deviatoricForceVec).norm(), 0);
+  EXPECT_EQ(toMatrix(f.forces.aggregationForceVec).norm(), 0);
+};
+
+/**
+ * @brief Test whether skipping the diagnostic decompositions leaves the total
+ * force unchanged, and whether they are recovered on demand
+ */
+TEST_F(ForceTest, LazyForceDiagnosticsTest) {
+  std::size_t nSub = 0;
+  mem3dg::solver::System f(topologyMatrix, vertexMatrix, p, nSub);
+  f.computePhysicalForcing();
+  EigenVectorX3dr mechanicalForceVec = toMatrix(f.forces.mechanicalForceVec);
+  EigenVectorX3dr areaGradVec = toMatrix(f.forces.bendingForceVec_areaGrad);
+  EigenVectorX1d bendingForce = toMatrix(f.forces.bendingForce);
+
+  // the diagnostics of the previous computation are zeroed, not kept stale
+  f.forces.isDiagnostic = false;
+  f.computePhysicalForcing();
+  EXPECT_TRUE(toMatrix(f.forces.mechanicalForceVec) == mechanicalForceVec);
+  EXPECT_EQ(toMatrix(f.forces.bendingForceVec_areaGrad).norm(), 0);
+  EXPECT_EQ(toMatrix(f.forces.bendingForce).norm(), 0);
+
+  f.computeForceDiagnostics();
+  EXPECT_FALSE(f.forces.isDiagnostic);
+  EXPECT_TRUE(toMatrix(f.forces.bendingForceVec_areaGrad) == areaGradVec);
+  EXPECT_TRUE(toMatrix(f.forces.bendingForce) == bendingForce);
+
+  // the integrated force, including the DPD terms, is left untouched
+  f.parameters.dpd.gamma = 1;
+  f.computePhysicalForcing(1e-5);
+  mechanicalForceVec = toMatrix(f.forces.mechanicalForceVec);
+  double mechErrorNorm = f.mechErrorNorm;
+  f.computeForceDiagnostics();
+  EXPECT_TRUE(toMatrix(f.forces.mechanicalForceVec) == mechanicalForceVec);
+  EXPECT_EQ(f.mechErrorNorm, mechErrorNorm);
+};
+
+/**
+ * @brief Test whether self-avoidance computed with the cell list is identical
+ * to the all-pairs computation when the cutoff includes all pairs
+ */
+TEST_F(ForceTest, SelfAvoidanceCellListTest) {
+  std::size_t nSub = 0;
+  mem3dg::solver::System f(topologyMatrix, vertexMatrix, p, nSub);
+
+  f.parameters.selfAvoidance.r = 0;
+  f.computeSelfAvoidanceForce();
+  f.computeSelfAvoidanceEnergy();
+  EigenVectorX3dr allPairsForceVec = toMatrix(f.forces.selfAvoidanceForceVec);
+  double allPairsEnergy = f.energy.selfAvoidancePenalty;
+
+  f.parameters.selfAvoidance.r = 1e3;
+  f.computeSelfAvoidanceForce();
+  f.computeSelfAvoidanceEnergy();
+  EXPECT_TRUE(toMatrix(f.forces.selfAvoidanceForceVec) == allPairsForceVec);
+  EXPECT_EQ(f.energy.selfAvoidancePenalty, allPairsEnergy);
+};
+
+/**
+ * @brief Test whether the self-avoidance neighbor list with skin is reused for
+ * small displacements and gives the same force as a fresh build
+ */
+TEST_F(ForceTest, SelfAvoidanceNeighborListTest) {
+  std::size_t nSub = 0;
+  mem3dg::solver::System f(topologyMatrix, vertexMatrix, p, nSub);
+  f.parameters.selfAvoidance.r = 0.5;
+  f.parameters.selfAvoidance.skin = 0.2;
+  f.computeSelfAvoidanceForce();
+
+  // displace less than half of the skin
+  toMatrix(f.vpg->inputVertexPositions).array() += 0.05;
+  EXPECT_FALSE(f.requireSelfAvoidanceNeighbors());
+  f.computeSelfAvoidanceForce();
+  EigenVectorX3dr verletForceVec = toMatrix(f.forces.selfAvoidanceForceVec);
+
+  f.updateSelfAvoidanceNeighbors();
+  f.computeSelfAvoidanceForce();
+  EXPECT_TRUE(toMatrix(f.forces.selfAvoidanceForceVec) == verletForceVec);
+
+  // displace more than half of the skin
+  toMatrix(f.vpg->inputVertexPositions).array() += 0.2;
+  EXPECT_TRUE(f.requireSelfAvoidanceNeighbors());
+};
+
 /**
  * @brief Test whether integrating with the force will lead to
  * 1. decrease in energy
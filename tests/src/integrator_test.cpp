@@ -12,6 +12,8 @@
 //     Padmini Rangamani (prangamani@eng.ucsd.edu)
 //
 
+#include <cmath>
+#include <cstdio>
 #include <iostream>
 
 #include <gtest/gtest.h>
@@ -74,6 +76,142 @@ TEST_F(IntegratorTest, ConjugateGradientIntegratorTest) {
 //   integrator.integrate();
 // }
 
+/**
+ * @brief The interpolating line search takes no more energy evaluations per
+ * line search than the fixed discount, and relaxes to the same energy
+ */
+TEST_F(IntegratorTest, InterpolatingLineSearchTest) {
+  const double tol = 1e-3;
+  double energyEvaluations[2], potentialEnergy[2];
+  for (bool isInterpolating : {false, true}) {
+    mem3dg::solver::System f(mesh, vpg, p, 0);
+    mem3dg::solver::integrator::ConjugateGradient integrator{
+        f, dt, T, tSave, tol, outputDir};
+    integrator.verbosity = verbosity;
+    integrator.isInterpolatingLineSearch = isInterpolating;
+    EXPECT_TRUE(integrator.integrate());
+    EXPECT_GT(integrator.nLineSearch, 0);
+    energyEvaluations[isInterpolating] =
+        integrator.getAverageEnergyEvaluations();
+    potentialEnergy[isInterpolating] = f.energy.potentialEnergy;
+  }
+  EXPECT_LE(energyEvaluations[true], energyEvaluations[false]);
+  EXPECT_NEAR(potentialEnergy[true], potentialEnergy[false],
+              1e-3 * std::abs(potentialEnergy[false]));
+}
+
+TEST_F(IntegratorTest, LBFGSIntegratorTest) {
+  mem3dg::solver::System f(mesh, vpg, p, 0);
+  mem3dg::solver::integrator::LBFGS integrator{f,     dt,  T,
+                                               tSave, eps, outputDir};
+  integrator.trajFileName = "traj.nc";
+  integrator.verbosity = verbosity;
+  integrator.integrate();
+}
+
+TEST_F(IntegratorTest, FIREIntegratorTest) {
+  mem3dg::solver::System f(mesh, vpg, p, 0);
+  mem3dg::solver::integrator::FIRE integrator{f, dt, T, tSave, eps, outputDir};
+  integrator.trajFileName = "traj.nc";
+  integrator.verbosity = verbosity;
+  integrator.integrate();
+}
+
+/**
+ * @brief Integration interrupted by a checkpoint and restarted from it
+ * reproduces the uninterrupted run bitwise, state and trajectory
+ */
+TEST_F(IntegratorTest, CheckpointContinuationTest) {
+  // every step is a frame, but the restart does not repeat the frame of the
+  // checkpoint
+  const double tSaveStep = 1e-6 * dt, tRestart = 2.5, tEnd = 5;
+  mem3dg::solver::MeshProcessor mp;
+  auto setUp = [&](mem3dg::solver::integrator::Euler &integrator,
+                   const std::string &trajFileName) {
+    integrator.trajFileName = trajFileName;
+    integrator.verbosity = 1;
+    integrator.processMeshPeriod = 1e10;
+    integrator.updateGeodesicsPeriod = 1e10;
+  };
+
+  // uninterrupted run
+  mem3dg::solver::System f(mesh, vpg, p, mp, 0, 0);
+  {
+    mem3dg::solver::integrator::Euler integrator{f,         dt,  tEnd,
+                                                 tSaveStep, eps, outputDir};
+    setUp(integrator, "continuous.nc");
+    integrator.integrate();
+  }
+
+  // run interrupted after the first steps, leaving the last checkpoint
+  {
+    mem3dg::solver::System g(mesh, vpg, p, mp, 0, 0);
+    mem3dg::solver::integrator::Euler integrator{g,         dt,  tRestart,
+                                                 tSaveStep, eps, outputDir};
+    setUp(integrator, "restarted.nc");
+    integrator.isWriteCheckpoint = true;
+    integrator.integrate();
+  }
+#ifdef MEM3DG_WITH_NETCDF
+  // the unfinished run marked its trajectory, which the restart continues
+  std::rename((outputDir + "/restarted_most.nc").c_str(),
+              (outputDir + "/restarted.nc").c_str());
+#endif
+
+  // restart from the checkpoint for the remaining steps
+  std::map<std::string, double> counters;
+  std::map<std::string, mem3dg::EigenVectorX1d> arrays;
+  std::unique_ptr<mem3dg::solver::System> g =
+      mem3dg::solver::System::loadCheckpoint(outputDir + "/checkpoint.bin", p,
+                                             mp, &counters, &arrays);
+  {
+    mem3dg::solver::integrator::Euler integrator{*g,        dt,  tEnd,
+                                                 tSaveStep, eps, outputDir};
+    setUp(integrator, "restarted.nc");
+    integrator.restoreCheckpoint(counters, arrays);
+    integrator.integrate();
+  }
+
+  EXPECT_EQ(g->time, f.time);
+  EXPECT_EQ(mem3dg::toMatrix(g->vpg->inputVertexPositions),
+            mem3dg::toMatrix(f.vpg->inputVertexPositions));
+  EXPECT_EQ(g->proteinDensity.raw(), f.proteinDensity.raw());
+
+#ifdef MEM3DG_WITH_NETCDF
+  // the trajectories hold the same bytes frame by frame
+  auto continuous = mem3dg::solver::MutableTrajFile::openReadOnly(
+      outputDir + "/continuous_most.nc");
+  auto restarted = mem3dg::solver::MutableTrajFile::openReadOnly(
+      outputDir + "/restarted_most.nc");
+  ASSERT_EQ(restarted.nFrames(), continuous.nFrames());
+  EXPECT_GT(restarted.nFrames(), 2u);
+  for (std::size_t i = 0; i < continuous.nFrames(); ++i) {
+    EXPECT_EQ(restarted.getTime(i), continuous.getTime(i));
+    EXPECT_EQ(restarted.getTopology(i), continuous.getTopology(i));
+    EXPECT_EQ(restarted.getCoords(i), continuous.getCoords(i));
+    EXPECT_EQ(restarted.getVelocity(i), continuous.getVelocity(i));
+    EXPECT_EQ(restarted.getProteinDensity(i),
+              continuous.getProteinDensity(i));
+  }
+#endif
+}
+
+/**
+ * @brief FIRE converges to the tolerance within the iteration budget, timed
+ * against Conjugate Gradient in BM_RelaxationFIRE of the benchmarks
+ */
+TEST_F(IntegratorTest, FIREConvergenceTest) {
+  const double tol = 1e-3;
+  const std::size_t maxIterations = 1000;
+  mem3dg::solver::System f(mesh, vpg, p, 0);
+  mem3dg::solver::integrator::FIRE integrator{f, dt, T, tSave, tol, outputDir};
+  integrator.verbosity = verbosity;
+  EXPECT_TRUE(integrator.integrate());
+  EXPECT_LT(f.mechErrorNorm, tol);
+  EXPECT_GT(integrator.nIterations, 0u);
+  EXPECT_LT(integrator.nIterations, maxIterations);
+}
+
 TEST_F(IntegratorTest, VelocityVerletIntegratorTest) {
   mem3dg::solver::System f(mesh, vpg, p, 0);
   mem3dg::solver::integrator::VelocityVerlet integrator{f,     dt,  1,
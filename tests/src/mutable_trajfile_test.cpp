@@ -12,10 +12,13 @@
 //     Padmini Rangamani (prangamani@eng.ucsd.edu)
 //
 
+#include <fstream>
 #include <iostream>
+#include <iterator>
 
 #include <gtest/gtest.h>
 
+#include "mem3dg/constants.h"
 #include "mem3dg/mem3dg"
 #include "mem3dg/type_utilities.h"
 #include <Eigen/Core>
@@ -69,4 +72,176 @@ TEST_F(MutableTrajfileTest, ReadWriteTopologyCoordinates) {
   ASSERT_EQ(coords, g2);
 }
 
+TEST_F(MutableTrajfileTest, TopologyRevisions) {
+  std::tie(mesh, vpg) = mem3dg::icosphere(1, 0);
+  t1 = mesh->getFaceVertexMatrix<std::uint32_t>();
+  std::tie(mesh, vpg) = mem3dg::icosphere(1, 1);
+  t2 = mesh->getFaceVertexMatrix<std::uint32_t>();
+
+  f.writeTopology(0, t1);
+  f.writeTopology(1, t1);
+  f.writeTopology(2, t2);
+  f.writeTopology(3, t2);
+  f.writeTopology(4, t1);
+  f.close();
+
+  auto fd = mem3dg::solver::MutableTrajFile::openReadOnly("test.nc");
+  ASSERT_EQ(fd.nFrames(), 5u);
+  EXPECT_EQ(fd.nTopologyRevisions(), 3u);
+  EXPECT_EQ(fd.getTopologyRevision(1), fd.getTopologyRevision(0));
+  EXPECT_EQ(fd.getTopologyRevision(3), fd.getTopologyRevision(2));
+  EXPECT_NE(fd.getTopologyRevision(4), fd.getTopologyRevision(0));
+  EXPECT_EQ(fd.getTopology(1), t1);
+  EXPECT_EQ(fd.getTopology(3), t2);
+  EXPECT_EQ(fd.getTopology(4), t1);
+}
+
+/**
+ * @brief Files are only opened if their convention version matches their
+ * topology storage
+ */
+TEST_F(MutableTrajfileTest, ConventionsVersion) {
+  std::tie(mesh, vpg) = mem3dg::icosphere(1, 0);
+  f.writeTopology(0, *mesh);
+  f.close();
+  EXPECT_NO_THROW(mem3dg::solver::MutableTrajFile::openReadOnly("test.nc"));
+
+  // topology revisions under the legacy version
+  {
+    nc::NcFile fd("test.nc", nc::NcFile::write);
+    fd.putAtt(mem3dg::solver::CONVENTIONS_VERSION_NAME,
+              mem3dg::solver::CONVENTIONS_VERSION_LEGACY_VALUE);
+  }
+  EXPECT_THROW(mem3dg::solver::MutableTrajFile::openReadOnly("test.nc"),
+               std::runtime_error);
+
+  // unknown version
+  {
+    nc::NcFile fd("test.nc", nc::NcFile::write);
+    fd.putAtt(mem3dg::solver::CONVENTIONS_VERSION_NAME, "0.0.0");
+  }
+  EXPECT_THROW(mem3dg::solver::MutableTrajFile::openReadOnly("test.nc"),
+               std::runtime_error);
+}
+
+/**
+ * @brief An integrator writing its frames on the background thread produces
+ * the same trajectory as the synchronous writes
+ */
+TEST(AsyncTrajFileWriterTest, ByteEquivalence) {
+  Eigen::Matrix<std::size_t, Eigen::Dynamic, 3> topologyMatrix;
+  Eigen::Matrix<double, Eigen::Dynamic, 3> vertexMatrix;
+  std::tie(topologyMatrix, vertexMatrix) = mem3dg::getIcosphereMatrix(1, 2);
+  mem3dg::solver::Parameters p;
+  p.bending.Kbc = 8.22e-5;
+  p.tension.Ksg = 0.1;
+  p.tension.At = 4.0 * mem3dg::constants::PI;
+  p.osmotic.isPreferredVolume = true;
+  p.osmotic.Kv = 0.01;
+  p.osmotic.Vt = 4.0 / 3.0 * mem3dg::constants::PI * 0.7;
+
+  auto integrate = [&](const std::string &trajFileName, bool isAsyncWrite) {
+    mem3dg::solver::System f(topologyMatrix, vertexMatrix, p, 0);
+    mem3dg::solver::integrator::Euler integrator{f, 0.5, 5, 1, 0, "."};
+    integrator.trajFileName = trajFileName;
+    integrator.verbosity = 1;
+    integrator.isAsyncWrite = isAsyncWrite;
+    integrator.integrate();
+  };
+  integrate("sync.nc", false);
+  integrate("async.nc", true);
+
+  // the trajectories are marked as not converged with zero tolerance
+  std::ifstream a("sync_most.nc", std::ios::binary),
+      b("async_most.nc", std::ios::binary);
+  std::string bytesA{std::istreambuf_iterator<char>(a),
+                     std::istreambuf_iterator<char>()};
+  std::string bytesB{std::istreambuf_iterator<char>(b),
+                     std::istreambuf_iterator<char>()};
+  ASSERT_FALSE(bytesA.empty());
+  EXPECT_TRUE(bytesA == bytesB);
+}
+
+/**
+ * @brief Reduced precision storage is transparent to readers and recorded in
+ * the file
+ */
+TEST(MutableTrajFileSettingsTest, ReducedPrecision) {
+  std::unique_ptr<gcs::ManifoldSurfaceMesh> mesh;
+  std::unique_ptr<gcs::VertexPositionGeometry> vpg;
+  std::tie(mesh, vpg) = mem3dg::icosphere(1, 2);
+  mem3dg::EigenVectorX3dr coords =
+      gc::EigenMap<double, 3>(vpg->inputVertexPositions);
+  mem3dg::EigenVectorX1d phi =
+      mem3dg::EigenVectorX1d::LinSpaced(mesh->nVertices(), 0, 1);
+
+  {
+    mem3dg::solver::MutableTrajFile f;
+    f.settings.coordinates.precision =
+        mem3dg::solver::TrajVariableSettings::Float;
+    f.settings.coordinates.chunkSize = 10;
+    f.settings.proteinDensity.precision =
+        mem3dg::solver::TrajVariableSettings::Fixed;
+    f.settings.proteinDensity.quantum = 1e-4;
+    f.settings.topology.compressionLevel = 0;
+    f.createNewFile("precision.nc", nc::NcFile::replace);
+    f.writeTime(0, 0);
+    f.writeTopology(0, *mesh);
+    f.writeCoords(0, coords);
+    f.writeProteinDensity(0, phi);
+    EXPECT_LT((f.getCoords(0) - coords).cwiseAbs().maxCoeff(), 1e-6);
+    f.close();
+  }
+
+  auto f = mem3dg::solver::MutableTrajFile::openReadOnly("precision.nc");
+  EXPECT_EQ(f.settings.coordinates.precision,
+            mem3dg::solver::TrajVariableSettings::Float);
+  EXPECT_EQ(f.settings.proteinDensity.precision,
+            mem3dg::solver::TrajVariableSettings::Fixed);
+  EXPECT_LT((f.getCoords(0) - coords).cwiseAbs().maxCoeff(), 1e-6);
+  EXPECT_LE((f.getProteinDensity(0) - phi).cwiseAbs().maxCoeff(), 0.5e-4);
+  mem3dg::EigenVectorX3ur top = f.getTopology(0);
+  EXPECT_TRUE(top == mesh->getFaceVertexMatrix<std::uint32_t>());
+}
+
+TEST(TrajFrameCacheTest, CachedFramesMatchFile) {
+  std::unique_ptr<gcs::ManifoldSurfaceMesh> mesh;
+  std::unique_ptr<gcs::VertexPositionGeometry> vpg;
+  std::tie(mesh, vpg) = mem3dg::icosphere(1, 2);
+  {
+    mem3dg::solver::MutableTrajFile f;
+    f.createNewFile("cache.nc", nc::NcFile::replace);
+    for (std::size_t i = 0; i < 6; ++i) {
+      mem3dg::solver::TrajFrame frame;
+      frame.time = i;
+      frame.topology = mesh->getFaceVertexMatrix<std::uint32_t>();
+      if (i >= 3)
+        frame.topology.col(0).swap(frame.topology.col(1));
+      frame.coordinates =
+          (1 + 0.1 * i) * gc::EigenMap<double, 3>(vpg->inputVertexPositions);
+      frame.velocity = 0.1 * i * frame.coordinates;
+      frame.proteinDensity =
+          mem3dg::EigenVectorX1d::Constant(mesh->nVertices(), 0.1 * i);
+      frame.write(f, i);
+    }
+    f.close();
+  }
+
+  auto f = mem3dg::solver::MutableTrajFile::openReadOnly("cache.nc");
+  mem3dg::solver::TrajFrameCache cache("cache.nc", 4);
+  ASSERT_EQ(cache.nFrames(), f.nFrames());
+  for (std::size_t i = 0; i < cache.nFrames(); ++i) {
+    EXPECT_EQ(cache.getTime(i), f.getTime(i));
+    EXPECT_TRUE(cache.getTopology(i) == f.getTopology(i));
+    EXPECT_TRUE(cache.getCoords(i) == f.getCoords(i));
+    EXPECT_TRUE(cache.getVelocity(i) == f.getVelocity(i));
+    EXPECT_TRUE(cache.getProteinDensity(i) == f.getProteinDensity(i));
+  }
+  EXPECT_GE(cache.nHits, 4 * cache.nFrames());
+
+  // frames of the same connectivity share the topology
+  EXPECT_EQ(cache.getFrame(4)->topology, cache.getFrame(5)->topology);
+  EXPECT_EQ(cache.getTopologyHash(4), cache.getTopologyHash(5));
+  EXPECT_NE(cache.getTopologyHash(0), cache.getTopologyHash(5));
+}
 #endif
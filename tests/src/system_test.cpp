@@ -0,0 +1,294 @@
+// Membrane Dynamics in 3D using Discrete Differential Geometry (Mem3DG)
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright (c) 2020:
+//     Laboratory for Computational Cellular Mechanobiology
+//     Cuncheng Zhu (cuzhu@eng.ucsd.edu)
+//     Christopher T. Lee (ctlee@ucsd.edu)
+//     Ravi Ramamoorthi (ravir@cs.ucsd.edu)
+//     Padmini Rangamani (prangamani@eng.ucsd.edu)
+//
+
+#include <gtest/gtest.h>
+
+#include "mem3dg/constants.h"
+#include "mem3dg/mem3dg"
+#include <Eigen/Core>
+
+namespace mem3dg {
+namespace solver {
+
+class SystemTest : public ::testing::Test {
+protected:
+  Parameters p;
+
+  SystemTest() {
+    p.bending.Kbc = 8.22e-5;
+    p.selfAvoidance.mu = 1e-5;
+    p.selfAvoidance.d = 0.01;
+  }
+};
+
+/**
+ * @brief Self-avoidance violation is detected at construction
+ */
+TEST_F(SystemTest, SelfAvoidanceViolationTest) {
+  Eigen::Matrix<std::size_t, Eigen::Dynamic, 3> topologyMatrix;
+  Eigen::Matrix<double, Eigen::Dynamic, 3> vertexMatrix;
+  std::tie(topologyMatrix, vertexMatrix) = getIcosphereMatrix(1, 2);
+  p.selfAvoidance.d = 1;
+  EXPECT_THROW(System(topologyMatrix, vertexMatrix, p, 0), std::runtime_error);
+}
+
+/**
+ * @brief Selective geometry refresh only plans the quantities needed by the
+ * parameters and agrees with the full refresh
+ */
+TEST_F(SystemTest, GeometryRefreshTest) {
+  Eigen::Matrix<std::size_t, Eigen::Dynamic, 3> topologyMatrix;
+  Eigen::Matrix<double, Eigen::Dynamic, 3> vertexMatrix;
+  std::tie(topologyMatrix, vertexMatrix) = getIcosphereMatrix(1, 3);
+  System f(topologyMatrix, vertexMatrix, p, 0);
+  auto isPlanned = [&f](const std::string &name) {
+    for (auto &q : f.geometryRefreshPlanner.quantities)
+      if (q.name == name)
+        return q.isPlanned;
+    return false;
+  };
+  EXPECT_TRUE(isPlanned("VertexMeanCurvatures"));
+  EXPECT_FALSE(isPlanned("VertexGaussianCurvatures"));
+  EXPECT_FALSE(isPlanned("CotanLaplacian"));
+  EXPECT_FALSE(isPlanned("DECOperators"));
+
+  // deviatoric rigidity plans the Gaussian curvature on the next refresh
+  f.parameters.bending.Kd = 8.22e-5;
+  toMatrix(f.vpg->inputVertexPositions) *= 1.1;
+  f.refreshGeometry();
+  EXPECT_TRUE(isPlanned("VertexGaussianCurvatures"));
+  EigenVectorX1d H = f.vpg->vertexMeanCurvatures.raw();
+  EigenVectorX1d K = f.vpg->vertexGaussianCurvatures.raw();
+  double A = f.vpg->faceAreas.raw().sum();
+
+  f.vpg->refreshQuantities();
+  EXPECT_EQ((H - f.vpg->vertexMeanCurvatures.raw()).norm(), 0);
+  EXPECT_EQ((K - f.vpg->vertexGaussianCurvatures.raw()).norm(), 0);
+  EXPECT_EQ(A, f.vpg->faceAreas.raw().sum());
+
+  // and releases it again without
+  f.parameters.bending.Kd = 0;
+  f.refreshGeometry();
+  EXPECT_FALSE(isPlanned("VertexGaussianCurvatures"));
+  f.geometryRefreshPlanner.summarizeTiming();
+}
+
+/**
+ * @brief In-place cotan Laplacian matches the geometry-central assembly, also
+ * after the mesh mutates
+ */
+TEST_F(SystemTest, CotanLaplacianTest) {
+  Eigen::Matrix<std::size_t, Eigen::Dynamic, 3> topologyMatrix;
+  Eigen::Matrix<double, Eigen::Dynamic, 3> vertexMatrix;
+  std::tie(topologyMatrix, vertexMatrix) = getIcosphereMatrix(1, 3);
+  System f(topologyMatrix, vertexMatrix, p, 0);
+  f.vpg->requireCotanLaplacian();
+  for (std::size_t i = 0; i < 2; ++i) {
+    f.cotanLaplacianAssembler.update(f.vpg->halfedgeCotanWeights.raw());
+    Eigen::SparseMatrix<double> difference =
+        f.cotanLaplacianAssembler.matrix - f.vpg->cotanLaplacian;
+    EXPECT_LT(difference.norm(), 1e-12 * f.vpg->cotanLaplacian.norm());
+
+    // grow the mesh and refresh
+    f.meshProcessor.meshMutator.isSplitEdge = true;
+    f.meshProcessor.meshMutator.splitLarge = true;
+    f.meshProcessor.meshMutator.targetFaceArea = 0.001;
+    f.meshProcessor.summarizeStatus();
+    f.mutateMesh();
+    f.updateConfigurations();
+  }
+  EXPECT_EQ(f.cotanLaplacianAssembler.matrix.rows(), f.mesh->nVertices());
+  f.vpg->unrequireCotanLaplacian();
+}
+
+/**
+ * @brief Geodesic solver reuses the factorization only for unchanged geometry
+ * by default, and within tolerance when opted in
+ */
+TEST_F(SystemTest, GeodesicSolverTest) {
+  Eigen::Matrix<std::size_t, Eigen::Dynamic, 3> topologyMatrix;
+  Eigen::Matrix<double, Eigen::Dynamic, 3> vertexMatrix;
+  std::tie(topologyMatrix, vertexMatrix) = getIcosphereMatrix(1, 3);
+  System f(topologyMatrix, vertexMatrix, p, 0);
+  std::size_t nMisses = f.geodesicSolver.nMisses;
+  EigenVectorX1d distance = f.geodesicDistanceFromPtInd.raw();
+
+  // unchanged geometry reuses the factorization exactly
+  f.updateConfigurations(true);
+  EXPECT_EQ(f.geodesicSolver.nMisses, nMisses);
+  EXPECT_EQ((f.geodesicDistanceFromPtInd.raw() - distance).norm(), 0);
+
+  // any motion refactorizes by default
+  toMatrix(f.vpg->inputVertexPositions) *= 1 + 1e-12;
+  f.updateConfigurations(true);
+  EXPECT_EQ(f.geodesicSolver.nMisses, nMisses + 1);
+  EXPECT_GT(f.geodesicSolver.nHits, 0);
+
+  // drift within an opted in tolerance is reused, beyond it refactorizes
+  f.geodesicSolver.tolerance = 0.1;
+  toMatrix(f.vpg->inputVertexPositions) *= 1 + 1e-3;
+  f.updateConfigurations(true);
+  EXPECT_EQ(f.geodesicSolver.nMisses, nMisses + 1);
+  toMatrix(f.vpg->inputVertexPositions) *= 1.5;
+  f.updateConfigurations(true);
+  EXPECT_EQ(f.geodesicSolver.nMisses, nMisses + 2);
+}
+
+/**
+ * @brief Energy only evaluation agrees with the full update and leaves the
+ * cached state untouched
+ */
+TEST_F(SystemTest, EvaluatePotentialEnergyTest) {
+  Eigen::Matrix<std::size_t, Eigen::Dynamic, 3> topologyMatrix;
+  Eigen::Matrix<double, Eigen::Dynamic, 3> vertexMatrix;
+  std::tie(topologyMatrix, vertexMatrix) = getIcosphereMatrix(1, 3);
+  p.bending.Kd = 8.22e-5;
+  p.adsorption.epsilon = -1e-3;
+  System f(topologyMatrix, vertexMatrix, p, 0);
+  f.computePotentialEnergy();
+  const double energy = f.energy.potentialEnergy;
+
+  // trial configuration
+  const EigenVectorX3dr initialPositions =
+      toMatrix(f.vpg->inputVertexPositions);
+  EigenVectorX3dr positions = initialPositions;
+  positions.col(2) *= 1.2;
+  EigenVectorX1d protein = f.proteinDensity.raw();
+  double trialEnergy = f.evaluatePotentialEnergy(positions, protein);
+  EXPECT_EQ(f.energy.potentialEnergy, energy);
+
+  toMatrix(f.vpg->inputVertexPositions) = positions;
+  f.updateConfigurations(false);
+  EXPECT_NEAR(trialEnergy, f.computePotentialEnergy(),
+              1e-10 * std::abs(trialEnergy));
+
+  // candidate pairs reserved at the initial positions give the same energy
+  // as a cell list built for the trial
+  f.parameters.selfAvoidance.r = 0.1;
+  double freshEnergy = f.evaluatePotentialEnergy(positions, protein);
+  f.reserveTrialPairs(
+      initialPositions,
+      (positions - initialPositions).rowwise().norm().maxCoeff());
+  EXPECT_EQ(f.evaluatePotentialEnergy(positions, protein), freshEnergy);
+}
+
+/**
+ * @brief Fused energy passes agree with the per-term computation
+ */
+TEST_F(SystemTest, FusedPotentialEnergyTest) {
+  Eigen::Matrix<std::size_t, Eigen::Dynamic, 3> topologyMatrix;
+  Eigen::Matrix<double, Eigen::Dynamic, 3> vertexMatrix;
+  std::tie(topologyMatrix, vertexMatrix) = getIcosphereMatrix(1, 3);
+  p.bending.Kd = 8.22e-5;
+  p.adsorption.epsilon = -1e-3;
+  p.aggregation.chi = -1e-4;
+  System f(topologyMatrix, vertexMatrix, p, 0);
+  toMatrix(f.vpg->inputVertexPositions).col(2) *= 1.2;
+  f.updateConfigurations(false);
+  f.computePotentialEnergy();
+  Energy fused = f.energy;
+
+  f.computeBendingEnergy();
+  f.computeDeviatoricEnergy();
+  f.computeAdsorptionEnergy();
+  f.computeAggregationEnergy();
+  EXPECT_NEAR(fused.bendingEnergy, f.energy.bendingEnergy,
+              1e-12 * std::abs(f.energy.bendingEnergy));
+  EXPECT_NEAR(fused.deviatoricEnergy, f.energy.deviatoricEnergy,
+              1e-12 * std::abs(f.energy.deviatoricEnergy));
+  EXPECT_NEAR(fused.adsorptionEnergy, f.energy.adsorptionEnergy,
+              1e-12 * std::abs(f.energy.adsorptionEnergy));
+  EXPECT_NEAR(fused.aggregationEnergy, f.energy.aggregationEnergy,
+              1e-12 * std::abs(f.energy.aggregationEnergy));
+}
+
+/**
+ * @brief Profiler times the phases and counts the energy evaluations
+ */
+TEST_F(SystemTest, ProfilerTest) {
+  Eigen::Matrix<std::size_t, Eigen::Dynamic, 3> topologyMatrix;
+  Eigen::Matrix<double, Eigen::Dynamic, 3> vertexMatrix;
+  std::tie(topologyMatrix, vertexMatrix) = getIcosphereMatrix(1, 3);
+  System f(topologyMatrix, vertexMatrix, p, 0);
+  EXPECT_FALSE(f.profiler.isEnabled);
+  f.profiler.isEnabled = true;
+  f.profiler.reset();
+  f.updateConfigurations(false);
+  f.computePotentialEnergy();
+  f.computePhysicalForcing();
+  EXPECT_EQ(f.profiler.phases[Profiler::UpdateConfigurations].nCalls, 1u);
+  EXPECT_EQ(f.profiler.phases[Profiler::RefreshGeometry].nCalls, 1u);
+  EXPECT_EQ(f.profiler.phases[Profiler::ComputeMechanicalForces].nCalls, 1u);
+  EXPECT_EQ(f.profiler.counters[Profiler::EnergyEvaluations], 1u);
+  EXPECT_EQ(f.profiler.getCounts()["energyEvaluations"], 1u);
+  EXPECT_EQ(f.profiler.getTiming().count("updateConfigurations"), 1u);
+
+  f.profiler.isEnabled = false;
+  f.computePotentialEnergy();
+  EXPECT_EQ(f.profiler.counters[Profiler::EnergyEvaluations], 1u);
+  f.profiler.summarize();
+}
+
+/**
+ * @brief Restart from a checkpoint reproduces the state and the forces
+ */
+TEST_F(SystemTest, CheckpointTest) {
+  Eigen::Matrix<std::size_t, Eigen::Dynamic, 3> topologyMatrix;
+  Eigen::Matrix<double, Eigen::Dynamic, 3> vertexMatrix;
+  std::tie(topologyMatrix, vertexMatrix) = getIcosphereMatrix(1, 3);
+  p.bending.Kd = 8.22e-5;
+  p.adsorption.epsilon = -1e-3;
+  p.proteinMobility = 1;
+  p.variation.isProteinVariation = true;
+  p.proteinDistribution.protein0 = Eigen::MatrixXd::Constant(1, 1, 0.5);
+  MeshProcessor mp;
+  System f(topologyMatrix, vertexMatrix, p, mp, 0, 0);
+  f.time = 1.5;
+  toMatrix(f.velocity).setRandom();
+  f.proteinDensity.raw().setRandom();
+  f.proteinDensity.raw() = 0.5 + 0.1 * f.proteinDensity.raw().array();
+  f.proteinVelocity.raw().setRandom();
+  f.updateConfigurations(false);
+  f.computePhysicalForcing();
+  toMatrix(f.forces.externalForceVec).setRandom();
+  EigenVectorX1d history = EigenVectorX1d::LinSpaced(5, 0, 1);
+  f.saveCheckpoint("checkpoint.bin", {{"frame", 7}}, {{"history", history}});
+
+  std::map<std::string, double> counters;
+  std::map<std::string, EigenVectorX1d> arrays;
+  std::unique_ptr<System> g =
+      System::loadCheckpoint("checkpoint.bin", p, mp, &counters, &arrays);
+  EXPECT_EQ(counters["frame"], 7);
+  EXPECT_EQ(arrays["history"], history);
+  EXPECT_EQ(g->time, f.time);
+  EXPECT_EQ(g->mesh->getFaceVertexMatrix<std::size_t>(),
+            f.mesh->getFaceVertexMatrix<std::size_t>());
+  EXPECT_EQ(toMatrix(g->vpg->inputVertexPositions),
+            toMatrix(f.vpg->inputVertexPositions));
+  EXPECT_EQ(toMatrix(g->velocity), toMatrix(f.velocity));
+  EXPECT_EQ(g->proteinDensity.raw(), f.proteinDensity.raw());
+  EXPECT_EQ(g->proteinVelocity.raw(), f.proteinVelocity.raw());
+  EXPECT_EQ(toMatrix(g->forces.externalForceVec),
+            toMatrix(f.forces.externalForceVec));
+
+  // continuation is bitwise identical
+  g->computePhysicalForcing();
+  EXPECT_EQ(toMatrix(g->forces.mechanicalForceVec),
+            toMatrix(f.forces.mechanicalForceVec));
+  EXPECT_EQ(g->forces.chemicalPotential.raw(),
+            f.forces.chemicalPotential.raw());
+}
+
+} // namespace solver
+} // namespace mem3dg